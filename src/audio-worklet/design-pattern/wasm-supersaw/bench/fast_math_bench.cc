@@ -0,0 +1,222 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Error report and microbenchmark for FastMath.
+//
+// For every function and accuracy tier this reports the maximum error
+// against the double precision <cmath> result over the function's domain,
+// and the cost per sample of the block version. The cost of the float
+// <cmath> function in a plain loop is shown for comparison.
+//
+// Build and run with `make mathbench` in the parent directory.
+
+#include <time.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "FastMath.h"
+
+namespace {
+
+constexpr int32_t kNumErrorPoints = 1 << 20;
+constexpr int32_t kFramesPerBlock = SYNTHMARK_MAX_FRAMES_PER_RENDER;
+constexpr int32_t kTimedBlocks = 200000;
+
+int64_t GetNanoTime() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * SYNTHMARK_NANOS_PER_SECOND +
+         now.tv_nsec;
+}
+
+typedef void (*BlockFunction)(const synth_float_t*, synth_float_t*, int32_t);
+
+struct Function {
+  const char* name;
+  const char* error_kind;
+  // Inputs are spread from min to max, logarithmically when log_spaced.
+  double min_input;
+  double max_input;
+  bool log_spaced;
+  double (*reference)(double);
+  float (*library)(float);
+  BlockFunction tiers[3];
+};
+
+double Exp2(double x) {
+  return exp2(x);
+}
+double Log2(double x) {
+  return log2(x);
+}
+double Sin(double x) {
+  return sin(x);
+}
+double Cos(double x) {
+  return cos(x);
+}
+double Tanh(double x) {
+  return tanh(x);
+}
+float Exp2f(float x) {
+  return exp2f(x);
+}
+float Log2f(float x) {
+  return log2f(x);
+}
+float Sinf(float x) {
+  return sinf(x);
+}
+float Cosf(float x) {
+  return cosf(x);
+}
+float Tanhf(float x) {
+  return tanhf(x);
+}
+
+std::vector<synth_float_t> MakeInputs(const Function& function, int32_t n) {
+  std::vector<synth_float_t> inputs(n);
+  for (int32_t i = 0; i < n; i++) {
+    double position = static_cast<double>(i) / (n - 1);
+    inputs[i] = static_cast<synth_float_t>(
+        function.log_spaced
+            ? function.min_input *
+                  pow(function.max_input / function.min_input, position)
+            : function.min_input +
+                  (function.max_input - function.min_input) * position);
+  }
+  return inputs;
+}
+
+double MeasureError(const Function& function, BlockFunction block) {
+  std::vector<synth_float_t> inputs = MakeInputs(function, kNumErrorPoints);
+  std::vector<synth_float_t> outputs(kNumErrorPoints);
+  block(inputs.data(), outputs.data(), kNumErrorPoints);
+  const bool relative = function.error_kind[0] == 'r';
+  double max_error = 0;
+  for (int32_t i = 0; i < kNumErrorPoints; i++) {
+    double expected = function.reference(inputs[i]);
+    double error = fabs(outputs[i] - expected);
+    if (relative)
+      error /= fabs(expected);
+    max_error = fmax(max_error, error);
+  }
+  return max_error;
+}
+
+template <typename Render>
+double MeasureNanos(Render render, const std::vector<synth_float_t>& inputs) {
+  std::vector<synth_float_t> outputs(kFramesPerBlock);
+  volatile synth_float_t sink = 0;
+  const int64_t start = GetNanoTime();
+  for (int32_t block = 0; block < kTimedBlocks; block++) {
+    render(inputs.data() + (block & 7) * kFramesPerBlock, outputs.data());
+    sink = sink + outputs[0];
+  }
+  return static_cast<double>(GetNanoTime() - start) /
+      (static_cast<double>(kTimedBlocks) * kFramesPerBlock);
+}
+
+// pow has two inputs, so its error is measured on a grid.
+double MeasurePowError(BlockFunction log2_block, BlockFunction exp2_block) {
+  const int32_t n = 1024;
+  std::vector<synth_float_t> x(n);
+  std::vector<synth_float_t> log_x(n);
+  std::vector<synth_float_t> product(n);
+  double max_error = 0;
+  for (int32_t i = 0; i < n; i++)
+    x[i] = static_cast<synth_float_t>(0.01 * pow(1.0e4, i / (n - 1.0)));
+  log2_block(x.data(), log_x.data(), n);
+  for (int32_t j = 0; j < 64; j++) {
+    const synth_float_t y = -4.0f + 8.0f * j / 63;
+    for (int32_t i = 0; i < n; i++)
+      product[i] = y * log_x[i];
+    exp2_block(product.data(), product.data(), n);
+    for (int32_t i = 0; i < n; i++) {
+      double expected = pow(static_cast<double>(x[i]), y);
+      max_error = fmax(max_error, fabs(product[i] - expected) / expected);
+    }
+  }
+  return max_error;
+}
+
+}  // namespace
+
+int main() {
+  const Function functions[] = {
+      {"exp2", "relative", -20.0, 20.0, false, Exp2, Exp2f,
+       {FastMath::exp2<FastMath::FAST>, FastMath::exp2<FastMath::MEDIUM>,
+        FastMath::exp2<FastMath::ACCURATE>}},
+      {"log2", "absolute", 1.0e-6, 1.0e6, true, Log2, Log2f,
+       {FastMath::log2<FastMath::FAST>, FastMath::log2<FastMath::MEDIUM>,
+        FastMath::log2<FastMath::ACCURATE>}},
+      {"sin", "absolute", -100.0, 100.0, false, Sin, Sinf,
+       {FastMath::sin<FastMath::FAST>, FastMath::sin<FastMath::MEDIUM>,
+        FastMath::sin<FastMath::ACCURATE>}},
+      {"cos", "absolute", -100.0, 100.0, false, Cos, Cosf,
+       {FastMath::cos<FastMath::FAST>, FastMath::cos<FastMath::MEDIUM>,
+        FastMath::cos<FastMath::ACCURATE>}},
+      {"tanh", "absolute", -10.0, 10.0, false, Tanh, Tanhf,
+       {FastMath::tanh<FastMath::FAST>, FastMath::tanh<FastMath::MEDIUM>,
+        FastMath::tanh<FastMath::ACCURATE>}},
+  };
+  const char* tier_names[] = {"FAST", "MEDIUM", "ACCURATE"};
+
+  printf("SynthMark %d.%d fast math bench, %s\n", SYNTHMARK_MAJOR_VERSION,
+         SYNTHMARK_MINOR_VERSION, SYNTHMARK_SIMD_NAME);
+  printf("%-6s %-10s %-9s %11s %11s\n", "", "tier", "error", "max error",
+         "ns/sample");
+  for (const Function& function : functions) {
+    std::vector<synth_float_t> inputs =
+        MakeInputs(function, 8 * kFramesPerBlock);
+    for (int32_t tier = 0; tier < 3; tier++) {
+      BlockFunction block = function.tiers[tier];
+      double nanos = MeasureNanos(
+          [block](const synth_float_t* input, synth_float_t* output) {
+            block(input, output, kFramesPerBlock);
+          },
+          inputs);
+      printf("%-6s %-10s %-9s %11.2g %11.2f\n", function.name,
+             tier_names[tier], function.error_kind,
+             MeasureError(function, block), nanos);
+    }
+    float (*library)(float) = function.library;
+    double nanos = MeasureNanos(
+        [library](const synth_float_t* input, synth_float_t* output) {
+          for (int32_t i = 0; i < kFramesPerBlock; i++)
+            output[i] = library(input[i]);
+        },
+        inputs);
+    printf("%-6s %-10s %-9s %11s %11.2f\n", function.name, "<cmath>", "", "",
+           nanos);
+  }
+  const BlockFunction log2_tiers[] = {FastMath::log2<FastMath::FAST>,
+                                      FastMath::log2<FastMath::MEDIUM>,
+                                      FastMath::log2<FastMath::ACCURATE>};
+  const BlockFunction exp2_tiers[] = {FastMath::exp2<FastMath::FAST>,
+                                      FastMath::exp2<FastMath::MEDIUM>,
+                                      FastMath::exp2<FastMath::ACCURATE>};
+  for (int32_t tier = 0; tier < 3; tier++) {
+    printf("%-6s %-10s %-9s %11.2g   (|y| <= 4)\n", "pow", tier_names[tier],
+           "relative", MeasurePowError(log2_tiers[tier], exp2_tiers[tier]));
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the DPW and wavetable sawtooth oscillators.
+//
+// For a range of pitches this reports the cost per sample and the level of
+// everything that is not a harmonic of the note, which is mostly aliasing,
+// relative to the harmonics.
+//
+// Build and run with `make oscbench` in the parent directory.
+
+#include <time.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "SynthMark.h"
+#include "EngineContext.h"
+#include "SawtoothOscillator.h"
+#include "SawtoothOscillatorDPW.h"
+#include "SawtoothOscillatorWavetable.h"
+#include "SynthSimd.h"
+
+namespace {
+
+constexpr int32_t kSampleRate = SYNTHMARK_SAMPLE_RATE;
+constexpr int32_t kFramesPerBlock = SYNTHMARK_MAX_FRAMES_PER_RENDER;
+constexpr int32_t kTimedSeconds = 100;
+// Length of the spectrum. Notes are tuned to a whole number of cycles.
+constexpr int32_t kSpectrumSize = 16384;
+// Bins on each side of a harmonic that belong to it after windowing.
+constexpr int32_t kLeakageBins = 4;
+
+int64_t GetNanoTime() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * SYNTHMARK_NANOS_PER_SECOND +
+         now.tv_nsec;
+}
+
+// Pick a bin near the frequency whose aliases, folded back from multiples of
+// the sample rate, land well away from the harmonics.
+int32_t SelectBin(double frequency) {
+  int32_t bin = static_cast<int32_t>(frequency * kSpectrumSize / kSampleRate);
+  for (;; bin++) {
+    if ((bin & 1) == 0)
+      continue;
+    bool clean = true;
+    for (int32_t fold = 1; fold <= 4; fold++) {
+      int32_t offset = (fold * kSpectrumSize) % bin;
+      if (offset <= 2 * kLeakageBins || offset >= bin - 2 * kLeakageBins)
+        clean = false;
+    }
+    if (clean)
+      return bin;
+  }
+}
+
+// Power outside the harmonics relative to the harmonics, in dB.
+double MeasureAliasing(const std::vector<synth_float_t>& signal, int32_t bin) {
+  const int32_t n = kSpectrumSize;
+  std::vector<double> cosine(n);
+  std::vector<double> sine(n);
+  std::vector<double> windowed(n);
+  for (int32_t i = 0; i < n; i++) {
+    const double theta = 2.0 * M_PI * i / n;
+    cosine[i] = cos(theta);
+    sine[i] = sin(theta);
+    // 4 term Blackman-Harris, sidelobes below -92 dB.
+    const double window = 0.35875 - 0.48829 * cos(theta) +
+        0.14128 * cos(2 * theta) - 0.01168 * cos(3 * theta);
+    windowed[i] = signal[i] * window;
+  }
+  double harmonic_power = 0;
+  double other_power = 0;
+  for (int32_t k = kLeakageBins + 1; k < n / 2; k++) {
+    double re = 0;
+    double im = 0;
+    for (int32_t i = 0; i < n; i++) {
+      re += windowed[i] * cosine[(k * i) & (n - 1)];
+      im -= windowed[i] * sine[(k * i) & (n - 1)];
+    }
+    const double power = re * re + im * im;
+    int32_t distance = k % bin;
+    if (distance > bin / 2)
+      distance = bin - distance;
+    if (distance <= kLeakageBins)
+      harmonic_power += power;
+    else
+      other_power += power;
+  }
+  return 10.0 * log10(other_power / harmonic_power);
+}
+
+struct Result {
+  double nanos_per_sample;
+  double aliasing_db;
+};
+
+template <typename Oscillator>
+Result MeasureOscillator(double frequency, int32_t bin) {
+  EngineContext context(kSampleRate);
+  Oscillator oscillator;
+  oscillator.setEngineContext(&context);
+  Result result;
+
+  // Start one block in so the DPW delay lines are primed.
+  oscillator.generate(frequency, kFramesPerBlock);
+  std::vector<synth_float_t> signal(kSpectrumSize);
+  for (int32_t i = 0; i < kSpectrumSize; i += kFramesPerBlock) {
+    oscillator.generate(frequency, kFramesPerBlock);
+    for (int32_t j = 0; j < kFramesPerBlock; j++)
+      signal[i + j] = oscillator.output[j];
+  }
+  result.aliasing_db = MeasureAliasing(signal, bin);
+
+  const int32_t num_blocks = kTimedSeconds * kSampleRate / kFramesPerBlock;
+  volatile synth_float_t sink = 0;
+  const int64_t start = GetNanoTime();
+  for (int32_t block = 0; block < num_blocks; block++) {
+    oscillator.generate(frequency, kFramesPerBlock);
+    sink = sink + oscillator.output[0];
+  }
+  result.nanos_per_sample = static_cast<double>(GetNanoTime() - start) /
+      (static_cast<double>(num_blocks) * kFramesPerBlock);
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  static_assert(kSpectrumSize % kFramesPerBlock == 0,
+                "the spectrum must be a whole number of blocks");
+  printf("SynthMark %d.%d oscillator bench, rate = %d, %s\n",
+         SYNTHMARK_MAJOR_VERSION, SYNTHMARK_MINOR_VERSION, kSampleRate,
+         SYNTHMARK_SIMD_NAME);
+  printf("%10s  %-22s  %-22s\n", "", "DPW", "wavetable");
+  printf("%10s  %10s %11s  %10s %11s\n", "frequency", "ns/sample",
+         "aliasing", "ns/sample", "aliasing");
+  const double frequencies[] = {110.0, 440.0, 1760.0, 3520.0, 7040.0,
+                                12000.0};
+  for (double target : frequencies) {
+    const int32_t bin = SelectBin(target);
+    const double frequency = static_cast<double>(bin) * kSampleRate /
+        kSpectrumSize;
+    Result dpw = MeasureOscillator<SawtoothOscillatorDPW>(frequency, bin);
+    Result wavetable =
+        MeasureOscillator<SawtoothOscillatorWavetable>(frequency, bin);
+    printf("%7.1f Hz  %10.2f %8.1f dB  %10.2f %8.1f dB\n", frequency,
+           dpw.nanos_per_sample, dpw.aliasing_db, wavetable.nanos_per_sample,
+           wavetable.aliasing_db);
+  }
+  return 0;
+}
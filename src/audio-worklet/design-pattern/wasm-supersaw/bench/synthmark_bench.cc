@@ -0,0 +1,417 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Native SynthMark benchmark for the supersaw synth sources.
+//
+// Renders a fixed number of SimpleVoices as fast as possible and reports
+// the cost per frame, the distribution of per-burst render times and the
+// "voice mark": the number of voices that can be rendered while staying at
+// SYNTHMARK_TARGET_CPU_LOAD of one core.
+//
+// Build and run with `make bench` in the parent directory.
+
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "SynthMark.h"
+#include "SynthTools.h"
+#include "EngineContext.h"
+#include "DenormalGuard.h"
+#include "RealtimeAudit.h"
+#include "SimpleVoice.h"
+#include "VoiceRenderPool.h"
+
+namespace {
+
+// Length of each trial run while searching for the voice mark.
+constexpr double kVoiceMarkTrialSeconds = 0.5;
+
+struct BenchOptions {
+  int32_t num_voices = SYNTHMARK_NUM_VOICES_LATENCY;
+  int32_t num_seconds = SYNTHMARK_NUM_SECONDS;
+  int32_t sample_rate = SYNTHMARK_SAMPLE_RATE;
+  int32_t frames_per_burst = SYNTHMARK_FRAMES_PER_BURST;
+  int32_t frames_per_block = SYNTHMARK_FRAMES_PER_RENDER;
+  int32_t num_threads = 1;
+  // Voices left sounding, the rest are released and stop being rendered
+  // once they are silent. Negative means all of them.
+  int32_t num_audible = -1;
+  // Oscillators per voice.
+  int32_t unison = 7;
+  bool wavetable = false;
+  // Render with the CPU flushing denormals to zero, as Synthesizer does.
+  bool flush_denormals = true;
+  // Count denormal and non-finite samples at every stage of the voices.
+  bool count_samples = false;
+  bool real_time = false;
+  bool voice_mark = true;
+};
+
+struct BurstStats {
+  int64_t total_nanos = 0;
+  int64_t total_frames = 0;
+  // Render time of every burst in nanoseconds.
+  std::vector<int64_t> burst_nanos;
+  // How late each burst started when pacing in real time.
+  std::vector<int64_t> wakeup_nanos;
+  // Summed over the voices, when counting.
+  SampleCounters counters[SimpleVoice::kNumStages];
+};
+
+int64_t GetNanoTime() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * SYNTHMARK_NANOS_PER_SECOND +
+         now.tv_nsec;
+}
+
+void SleepUntilNanoTime(int64_t wakeup_time) {
+  struct timespec target;
+  target.tv_sec = wakeup_time / SYNTHMARK_NANOS_PER_SECOND;
+  target.tv_nsec = wakeup_time % SYNTHMARK_NANOS_PER_SECOND;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr)
+         != 0) {
+  }
+}
+
+int64_t GetPercentile(std::vector<int64_t> values, double percentile) {
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+  return values[index];
+}
+
+class VoiceBench {
+ public:
+  VoiceBench(const BenchOptions& options, int32_t num_voices)
+      : context_(options.sample_rate),
+        voices_(num_voices),
+        frames_per_burst_(options.frames_per_burst),
+        frames_per_block_(options.frames_per_block),
+        flush_denormals_(options.flush_denormals) {
+    mix_.resize(frames_per_block_);
+    active_.reserve(num_voices);
+#if SYNTHMARK_HAS_THREADS
+    if (options.num_threads > 1)
+      pool_.reset(new VoiceRenderPool(options.num_threads));
+#endif
+    // Spread the voices over a few octaves so that the oscillators do not
+    // run in lock step.
+    for (int32_t i = 0; i < num_voices; i++) {
+      voices_[i].setEngineContext(&context_);
+      voices_[i].setUnison(options.unison, 1.0f);
+      if (options.wavetable)
+        voices_[i].setOscillatorSource(SupersawOscillatorBank::WAVETABLE);
+      voices_[i].setSampleCounting(options.count_samples);
+      voices_[i].setPitch(48.0f + (i * 7) % 36);
+      voices_[i].start();
+      if (options.num_audible >= 0 && i >= options.num_audible)
+        voices_[i].stop();
+      active_.push_back(i);
+    }
+  }
+
+  // Render one burst and return the wall clock time it took.
+  int64_t RenderBurst() {
+    int64_t start = GetNanoTime();
+    ScopedRealtimeSection realtime;
+    std::optional<ScopedDenormalGuard> denormals;
+    if (flush_denormals_)
+      denormals.emplace();
+    int32_t frames_left = frames_per_burst_;
+    while (frames_left > 0) {
+      int32_t frames = std::min(frames_left, frames_per_block_);
+      SynthTools::fillBuffer(mix_.data(), frames, 0);
+#if SYNTHMARK_HAS_THREADS
+      if (pool_) {
+        auto generate_voice = [this, frames](int32_t task,
+                                             VoiceScratch* scratch) {
+          voices_[active_[task]].generate(frames, scratch);
+        };
+        pool_->run(static_cast<int32_t>(active_.size()), generate_voice);
+        for (int32_t index : active_)
+          SynthTools::addBuffers(voices_[index].output, 1.0, mix_.data(),
+                                 frames);
+      } else
+#endif
+      {
+        for (int32_t index : active_) {
+          voices_[index].generate(frames, &scratch_);
+          SynthTools::addBuffers(voices_[index].output, 1.0, mix_.data(),
+                                 frames);
+        }
+      }
+      DropInactiveVoices();
+      frames_left -= frames;
+    }
+    return GetNanoTime() - start;
+  }
+
+  // Like Synthesizer, stop rendering voices once they are silent.
+  void DropInactiveVoices() {
+    active_.erase(std::remove_if(active_.begin(), active_.end(),
+                                 [this](int32_t index) {
+                                   return !voices_[index].isActive();
+                                 }),
+                  active_.end());
+  }
+
+  // Read the mix so the compiler cannot discard the render.
+  synth_float_t GetLastSample() const {
+    return mix_[0];
+  }
+
+  void AddSampleCounters(SampleCounters* counters) const {
+    for (const SimpleVoice& voice : voices_) {
+      for (int32_t stage = 0; stage < SimpleVoice::kNumStages; stage++) {
+        counters[stage].add(
+            voice.getSampleCounters(static_cast<SimpleVoice::Stage>(stage)));
+      }
+    }
+  }
+
+ private:
+  EngineContext context_;
+  std::vector<SimpleVoice> voices_;
+  // Indices of the voices that are still sounding.
+  std::vector<int32_t> active_;
+  std::vector<synth_float_t> mix_;
+  VoiceScratch scratch_;
+#if SYNTHMARK_HAS_THREADS
+  std::unique_ptr<VoiceRenderPool> pool_;
+#endif
+  int32_t frames_per_burst_;
+  int32_t frames_per_block_;
+  bool flush_denormals_;
+};
+
+BurstStats RunBench(const BenchOptions& options, int32_t num_voices,
+                    double num_seconds, bool real_time) {
+  BurstStats stats;
+  const int64_t num_bursts = static_cast<int64_t>(
+      num_seconds * options.sample_rate / options.frames_per_burst);
+  const int64_t nanos_per_burst = SYNTHMARK_NANOS_PER_SECOND *
+      options.frames_per_burst / options.sample_rate;
+  stats.burst_nanos.reserve(num_bursts);
+  if (real_time)
+    stats.wakeup_nanos.reserve(num_bursts);
+
+  VoiceBench bench(options, num_voices);
+  volatile synth_float_t sink = 0;
+  int64_t next_burst_time = GetNanoTime();
+  for (int64_t burst = 0; burst < num_bursts; burst++) {
+    if (real_time) {
+      SleepUntilNanoTime(next_burst_time);
+      stats.wakeup_nanos.push_back(GetNanoTime() - next_burst_time);
+      next_burst_time += nanos_per_burst;
+    }
+    int64_t elapsed = bench.RenderBurst();
+    sink = sink + bench.GetLastSample();
+    stats.burst_nanos.push_back(elapsed);
+    stats.total_nanos += elapsed;
+    stats.total_frames += options.frames_per_burst;
+  }
+  bench.AddSampleCounters(stats.counters);
+  return stats;
+}
+
+double GetCpuLoad(const BenchOptions& options, const BurstStats& stats) {
+  double audio_nanos = static_cast<double>(stats.total_frames) *
+      SYNTHMARK_NANOS_PER_SECOND / options.sample_rate;
+  return stats.total_nanos / audio_nanos;
+}
+
+// Find the largest voice count whose load stays at or below the target.
+int32_t MeasureVoiceMark(const BenchOptions& options) {
+  auto fits = [&](int32_t num_voices) {
+    BurstStats stats =
+        RunBench(options, num_voices, kVoiceMarkTrialSeconds, false);
+    return GetCpuLoad(options, stats) <= SYNTHMARK_TARGET_CPU_LOAD;
+  };
+
+  int32_t low = 0;
+  int32_t high = 1;
+  while (high <= SYNTHMARK_MAX_VOICES && fits(high)) {
+    low = high;
+    high *= 2;
+  }
+  high = std::min(high, (int32_t) SYNTHMARK_MAX_VOICES + 1);
+  while (high - low > 1) {
+    int32_t middle = (low + high) / 2;
+    if (fits(middle))
+      low = middle;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+void PrintPercentiles(const char* label, const std::vector<int64_t>& nanos,
+                      int64_t nanos_per_burst) {
+  const double percentiles[] = {0.5, 0.9, 0.99, 1.0};
+  printf("%s\n", label);
+  for (double percentile : percentiles) {
+    int64_t value = GetPercentile(nanos, percentile);
+    printf("  p%-5g %10.1f us  (%5.1f%% of burst)\n", percentile * 100,
+           value / 1000.0, 100.0 * value / nanos_per_burst);
+  }
+}
+
+void PrintUsage(const char* program) {
+  printf("Usage: %s [-n voices] [-s seconds] [-r rate] [-b burst] [-f block]"
+         " [-t threads] [-a audible] [-u unison] [-w] [-d] [-c] [-j] [-q]\n"
+         "  -n  number of voices, default %d (%d with -j)\n"
+         "  -s  seconds of audio to render, default %d\n"
+         "  -r  sample rate, default %d\n"
+         "  -b  frames per burst, default %d\n"
+         "  -f  frames per block, at most %d, default %d\n"
+         "  -t  render threads, at most %d, default 1\n"
+         "  -a  voices to keep sounding, the others are released and stop\n"
+         "      being rendered once silent, default all\n"
+         "  -u  oscillators per voice, at most %d, default 7\n"
+         "  -w  use wavetable instead of DPW sawtooth oscillators\n"
+         "  -d  do not flush denormals to zero, needs -t 1\n"
+         "  -c  count denormal, NaN and infinite samples of each stage\n"
+         "  -j  pace bursts in real time and report wakeup jitter\n"
+         "  -q  skip the voice mark search\n",
+         program, SYNTHMARK_NUM_VOICES_LATENCY, SYNTHMARK_NUM_VOICES_JITTER,
+         SYNTHMARK_NUM_SECONDS, SYNTHMARK_SAMPLE_RATE,
+         SYNTHMARK_FRAMES_PER_BURST, SYNTHMARK_MAX_FRAMES_PER_RENDER,
+         SYNTHMARK_FRAMES_PER_RENDER, SYNTHMARK_MAX_RENDER_THREADS,
+         SUPERSAW_MAX_OSCILLATORS);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  bool voices_set = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:r:b:f:t:a:u:wdcjqh")) != -1) {
+    switch (opt) {
+      case 'n':
+        options.num_voices = atoi(optarg);
+        voices_set = true;
+        break;
+      case 's':
+        options.num_seconds = atoi(optarg);
+        break;
+      case 'r':
+        options.sample_rate = atoi(optarg);
+        break;
+      case 'b':
+        options.frames_per_burst = atoi(optarg);
+        break;
+      case 'f':
+        options.frames_per_block = atoi(optarg);
+        break;
+      case 't':
+        options.num_threads = atoi(optarg);
+        break;
+      case 'a':
+        options.num_audible = atoi(optarg);
+        break;
+      case 'u':
+        options.unison = atoi(optarg);
+        break;
+      case 'w':
+        options.wavetable = true;
+        break;
+      case 'd':
+        options.flush_denormals = false;
+        break;
+      case 'c':
+        options.count_samples = true;
+        break;
+      case 'j':
+        options.real_time = true;
+        break;
+      case 'q':
+        options.voice_mark = false;
+        break;
+      default:
+        PrintUsage(argv[0]);
+        return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (options.real_time && !voices_set)
+    options.num_voices = SYNTHMARK_NUM_VOICES_JITTER;
+  if (options.num_voices < 1 || options.num_voices > SYNTHMARK_MAX_VOICES ||
+      options.num_seconds < 1 || options.sample_rate < 1 ||
+      options.frames_per_burst < 1 || options.frames_per_block < 1 ||
+      options.frames_per_block > SYNTHMARK_MAX_FRAMES_PER_RENDER ||
+      options.num_threads < 1 || options.unison < 1 ||
+      options.unison > SUPERSAW_MAX_OSCILLATORS ||
+      options.num_threads > SYNTHMARK_MAX_RENDER_THREADS ||
+      (!options.flush_denormals && options.num_threads > 1)) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  const int64_t nanos_per_burst = SYNTHMARK_NANOS_PER_SECOND *
+      options.frames_per_burst / options.sample_rate;
+
+  printf("SynthMark %d.%d native bench\n", SYNTHMARK_MAJOR_VERSION,
+         SYNTHMARK_MINOR_VERSION);
+  printf("voices = %d, seconds = %d, rate = %d, burst = %d frames, "
+         "block = %d frames, threads = %d, unison = %d, %s%s%s\n",
+         options.num_voices, options.num_seconds, options.sample_rate,
+         options.frames_per_burst, options.frames_per_block,
+         options.num_threads, options.unison,
+         options.wavetable ? "wavetable" : "DPW",
+         options.flush_denormals ? "" : ", denormals",
+         options.real_time ? ", real time" : "");
+
+  BurstStats stats = RunBench(options, options.num_voices,
+                              options.num_seconds, options.real_time);
+  double nanos_per_frame =
+      static_cast<double>(stats.total_nanos) / stats.total_frames;
+  printf("ns/frame          = %.2f\n", nanos_per_frame);
+  printf("ns/voice/frame    = %.2f\n", nanos_per_frame / options.num_voices);
+  printf("cpu load          = %.2f%%\n", 100.0 * GetCpuLoad(options, stats));
+  PrintPercentiles("burst render time:", stats.burst_nanos, nanos_per_burst);
+  if (options.real_time)
+    PrintPercentiles("wakeup jitter:", stats.wakeup_nanos, nanos_per_burst);
+  if (options.count_samples) {
+    const char* stage_names[] = {"oscillators", "noise", "filter",
+                                 "filter env", "amp env", "voice output"};
+    printf("%-17s %14s %10s %10s\n", "sample counts:", "samples",
+           "denormal", "NaN/inf");
+    for (int32_t stage = 0; stage < SimpleVoice::kNumStages; stage++) {
+      const SampleCounters& counters = stats.counters[stage];
+      printf("  %-15s %14lld %10lld %10lld\n", stage_names[stage],
+             static_cast<long long>(counters.samples),
+             static_cast<long long>(counters.denormals),
+             static_cast<long long>(counters.nonFinite));
+    }
+  }
+
+  if (options.voice_mark) {
+    int32_t voice_mark = MeasureVoiceMark(options);
+    printf("voice mark        = %d voices at %.0f%% load\n", voice_mark,
+           100.0 * SYNTHMARK_TARGET_CPU_LOAD);
+  }
+  return 0;
+}
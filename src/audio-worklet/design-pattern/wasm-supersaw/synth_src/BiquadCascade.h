@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_BIQUAD_CASCADE_H
+#define SYNTHMARK_BIQUAD_CASCADE_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "UnitGenerator.h"
+#include "DenormalGuard.h"
+#include "BiquadCoefficients.h"
+
+/**
+ * Two identical BiquadFilter lowpass stages in series, for a steeper slope.
+ *
+ * The output is bit identical to feeding one BiquadFilter into another with
+ * the same cutoffs and Q, but the coefficients are calculated once instead
+ * of once per stage, both stages run in the same loop and the delay lines
+ * stay in registers until the end of the block.
+ */
+class BiquadCascade : public UnitGenerator
+{
+public:
+    void setQ(synth_float_t q) {
+        mCoefficientEngine.setQ(q);
+    }
+
+    synth_float_t getQ() {
+        return mCoefficientEngine.getQ();
+    }
+
+    void reset() {
+        mStage1 = Stage();
+        mStage2 = Stage();
+    }
+
+    /**
+     * @param frequencies cutoff in Hz for each sample
+     */
+    void generate(const synth_float_t *input,
+                  const synth_float_t *frequencies,
+                  int32_t numSamples) {
+        generate(input, ControlBlock::audio(frequencies), numSamples);
+    }
+
+    /**
+     * @param frequency cutoff in Hz
+     */
+    void generate(const synth_float_t *input,
+                  const ControlBlock &frequency,
+                  int32_t numSamples) {
+        Stage s1 = mStage1;
+        Stage s2 = mStage2;
+        mCoefficientEngine.forEachSegment(frequency, numSamples,
+                getSamplePeriod(),
+                [&](int32_t start, int32_t count, BiquadCoefficients c,
+                    const BiquadCoefficients *delta) {
+            if (delta == nullptr) {
+                for (int32_t i = start; i < start + count; i++) {
+                    synth_float_t middle = s1.process(c, input[i]);
+                    output[i] = s2.process(c, middle);
+                }
+            } else {
+                for (int32_t i = start; i < start + count; i++) {
+                    c.add(*delta);
+                    synth_float_t middle = s1.process(c, input[i]);
+                    output[i] = s2.process(c, middle);
+                }
+            }
+        });
+        s1.flushDenormals();
+        s2.flushDenormals();
+        mStage1 = s1;
+        mStage2 = s2;
+        countOutput(numSamples);
+    }
+
+private:
+    // Same arithmetic as BiquadFilter::generate(), including the double
+    // precision recursive part.
+    struct Stage {
+        synth_float_t xn1 = 0;
+        synth_float_t xn2 = 0;
+        double yn1 = 0;
+        double yn2 = 0;
+
+        SYNTHMARK_ALWAYS_INLINE synth_float_t process(
+                const BiquadCoefficients &c, synth_float_t xn) {
+            synth_float_t finite = (c.a0 * xn) + (c.a1 * xn1) + (c.a2 * xn2);
+            synth_float_t yn = finite - (c.b1 * yn1) - (c.b2 * yn2);
+            xn2 = xn1;
+            xn1 = xn;
+            yn2 = yn1;
+            yn1 = yn;
+            return yn;
+        }
+
+        void flushDenormals() {
+            yn1 = DenormalGuard::flush(yn1);
+            yn2 = DenormalGuard::flush(yn2);
+        }
+    };
+
+    BiquadCoefficientEngine mCoefficientEngine;
+    Stage mStage1;
+    Stage mStage2;
+};
+
+#endif // SYNTHMARK_BIQUAD_CASCADE_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_BIQUAD_COEFFICIENTS_H
+#define SYNTHMARK_BIQUAD_COEFFICIENTS_H
+
+#include <cstdint>
+#include <math.h>
+#include "SynthMark.h"
+#include "ControlBlock.h"
+
+#define BIQUAD_MIN_FREQ      (0.00001f) // REVIEW
+#define BIQUAD_MIN_Q         (0.00001f) // REVIEW
+
+// Highest cutoff as a fraction of the sample rate. Any closer to Nyquist and
+// the filter blows up.
+#define BIQUAD_MAX_RATIO     0.499f
+
+// A varying cutoff is looked up at the end of every segment of this many
+// frames and the coefficients are ramped linearly in between.
+#define BIQUAD_RAMP_FRAMES   16
+
+/**
+ * Coefficients of a biquad section:
+ *   y[n] = a0*x[n] + a1*x[n-1] + a2*x[n-2] - b1*y[n-1] - b2*y[n-2]
+ */
+struct BiquadCoefficients
+{
+    synth_float_t a0 = 0;
+    synth_float_t a1 = 0;
+    synth_float_t a2 = 0;
+    synth_float_t b1 = 0;
+    synth_float_t b2 = 0;
+
+    /**
+     * Resonant lowpass.
+     * @param ratio cutoff frequency divided by the sample rate
+     * @param Q resonance
+     */
+    void setLowpass(synth_float_t ratio, synth_float_t Q);
+
+    /**
+     * Resonant lowpass from the sine and one minus the cosine of the cutoff
+     * in radians per sample, and 1 / (2 * Q).
+     */
+    void setLowpass(synth_float_t oneMinusCosine, synth_float_t sine,
+                    synth_float_t halfInverseQ) {
+        synth_float_t alpha = sine * halfInverseQ;
+        synth_float_t scalar = 1.0f / (1.0f + alpha);
+        synth_float_t omc = oneMinusCosine;
+
+        a0 = omc * 0.5f * scalar;
+        a1 = omc * scalar;
+        a2 = a0;
+        b1 = -2.0f * (1.0f - omc) * scalar;
+        b2 = (1.0f - alpha) * scalar;
+    }
+
+    /**
+     * Set this to (target - start) / numFrames so that adding it numFrames
+     * times moves from start to about target.
+     */
+    void setRamp(const BiquadCoefficients &start,
+                 const BiquadCoefficients &target,
+                 int32_t numFrames) {
+        const synth_float_t scaler = 1.0f / numFrames;
+        a0 = (target.a0 - start.a0) * scaler;
+        a1 = (target.a1 - start.a1) * scaler;
+        a2 = (target.a2 - start.a2) * scaler;
+        b1 = (target.b1 - start.b1) * scaler;
+        b2 = (target.b2 - start.b2) * scaler;
+    }
+
+    SYNTHMARK_ALWAYS_INLINE void add(const BiquadCoefficients &delta) {
+        a0 += delta.a0;
+        a1 += delta.a1;
+        a2 += delta.a2;
+        b1 += delta.b1;
+        b2 += delta.b2;
+    }
+};
+
+/**
+ * Trigonometry for the lowpass coefficients, tabulated against the cutoff
+ * ratio r so that setting or sweeping a cutoff needs no sin() or cos().
+ *
+ * The table holds (1 - cos(2 pi r)) / r^2 and sin(2 pi r) / r, which are
+ * smooth all the way down to r = 0, and multiplies the powers of r back in
+ * after interpolating. Interpolating cos() directly would lose most of the
+ * precision of 1 - cos() at low cutoffs, where it is tiny.
+ *
+ * The Q only enters the coefficients through 1 / (2 * Q), so it is applied
+ * exactly after the lookup and the table stays one dimensional.
+ */
+class BiquadTrigTable
+{
+public:
+    static constexpr int32_t kNumIntervals = 1024;
+    static constexpr double kMaxRatio = 0.5;
+
+    static const BiquadTrigTable &getInstance() {
+        static const BiquadTrigTable sTable;
+        return sTable;
+    }
+
+    void lookup(synth_float_t ratio, synth_float_t *oneMinusCosine,
+                synth_float_t *sine) const {
+        if (ratio >= BIQUAD_MAX_RATIO) ratio = BIQUAD_MAX_RATIO;
+        if (ratio < 0.0f) ratio = 0.0f;
+        synth_float_t position = ratio * (synth_float_t) (kNumIntervals / kMaxRatio);
+        int32_t index = (int32_t) position;
+        synth_float_t fraction = position - index;
+        synth_float_t omc = mOneMinusCosine[index]
+                + ((mOneMinusCosine[index + 1] - mOneMinusCosine[index])
+                        * fraction);
+        synth_float_t sin = mSine[index]
+                + ((mSine[index + 1] - mSine[index]) * fraction);
+        *oneMinusCosine = omc * ratio * ratio;
+        *sine = sin * ratio;
+    }
+
+private:
+    BiquadTrigTable() {
+        const double twoPi = 2.0 * M_PI;
+        // Limits at r = 0.
+        mOneMinusCosine[0] = (synth_float_t) (twoPi * twoPi * 0.5);
+        mSine[0] = (synth_float_t) twoPi;
+        for (int32_t i = 1; i <= kNumIntervals; i++) {
+            double r = i * kMaxRatio / kNumIntervals;
+            mOneMinusCosine[i] = (synth_float_t) ((1.0 - cos(twoPi * r)) / (r * r));
+            mSine[i] = (synth_float_t) (sin(twoPi * r) / r);
+        }
+    }
+
+    synth_float_t mOneMinusCosine[kNumIntervals + 1];
+    synth_float_t mSine[kNumIntervals + 1];
+};
+
+inline void BiquadCoefficients::setLowpass(synth_float_t ratio,
+                                           synth_float_t Q) {
+    synth_float_t oneMinusCosine;
+    synth_float_t sine;
+    BiquadTrigTable::getInstance().lookup(ratio, &oneMinusCosine, &sine);
+    setLowpass(oneMinusCosine, sine, 1.0f / (2.0f * Q));
+}
+
+/**
+ * Supplies lowpass coefficients that follow the cutoff frequencies of a
+ * block.
+ *
+ * When every cutoff in the block is the same, the coefficients are only
+ * recalculated if the cutoff or Q changed since the last block. A moving
+ * cutoff is looked up every BIQUAD_RAMP_FRAMES frames and the coefficients
+ * are interpolated per sample in between, so envelope sweeps are smooth
+ * without calculating coefficients for every sample. A CONSTANT or RAMP
+ * ControlBlock is used as is, an AUDIO block is first checked for a
+ * constant cutoff.
+ */
+class BiquadCoefficientEngine
+{
+public:
+    BiquadCoefficientEngine()
+        : mTable(&BiquadTrigTable::getInstance()) {}
+
+    void setQ(synth_float_t q) {
+        if (q < BIQUAD_MIN_Q) {
+            q = BIQUAD_MIN_Q;
+        }
+        mQ = q;
+    }
+
+    synth_float_t getQ() const {
+        return mQ;
+    }
+
+    /**
+     * Call segment(start, numFrames, coefficients, delta) for consecutive
+     * segments that cover the block. When delta is nullptr every frame of
+     * the segment uses the coefficients. Otherwise add delta to the
+     * coefficients before filtering each frame, which lands on the
+     * coefficients for the cutoff of the last frame.
+     */
+    template <typename Segment>
+    void forEachSegment(const ControlBlock &frequency, int32_t numFrames,
+                        synth_float_t samplePeriod, Segment segment) {
+        if (numFrames <= 0) {
+            return;
+        }
+        if (frequency.isConstant()
+                || (frequency.mode == ControlBlock::AUDIO
+                        && isConstant(frequency.samples, numFrames))) {
+            forConstant(frequency.getValue(0), numFrames, samplePeriod,
+                        segment);
+            return;
+        }
+
+        const synth_float_t halfInverseQ = 1.0f / (2.0f * mQ);
+        if (!mStarted) {
+            lookup(frequency.getValue(0), samplePeriod, halfInverseQ, &mCurrent);
+            mStarted = true;
+        }
+        mCached = false;
+        for (int32_t start = 0; start < numFrames;
+                start += BIQUAD_RAMP_FRAMES) {
+            int32_t count = numFrames - start;
+            if (count > BIQUAD_RAMP_FRAMES) count = BIQUAD_RAMP_FRAMES;
+            BiquadCoefficients target;
+            lookup(frequency.getValue(start + count - 1), samplePeriod,
+                   halfInverseQ, &target);
+            BiquadCoefficients delta;
+            delta.setRamp(mCurrent, target, count);
+            segment(start, count, mCurrent, &delta);
+            // Land exactly on the target so rounding does not accumulate.
+            mCurrent = target;
+        }
+    }
+
+    template <typename Segment>
+    void forEachSegment(const synth_float_t *frequencies, int32_t numFrames,
+                        synth_float_t samplePeriod, Segment segment) {
+        forEachSegment(ControlBlock::audio(frequencies), numFrames,
+                       samplePeriod, segment);
+    }
+
+private:
+    template <typename Segment>
+    void forConstant(synth_float_t frequency, int32_t numFrames,
+                     synth_float_t samplePeriod, Segment segment) {
+        if (!mCached || frequency != mCachedFrequency || mQ != mCachedQ) {
+            mCurrent.setLowpass(clampFrequency(frequency) * samplePeriod, mQ);
+            mCached = true;
+            mCachedFrequency = frequency;
+            mCachedQ = mQ;
+            mStarted = true;
+        }
+        segment(0, numFrames, mCurrent,
+                static_cast<const BiquadCoefficients *>(nullptr));
+    }
+
+    static synth_float_t clampFrequency(synth_float_t frequency) {
+        return (frequency < BIQUAD_MIN_FREQ) ? BIQUAD_MIN_FREQ : frequency;
+    }
+
+    static bool isConstant(const synth_float_t *frequencies,
+                           int32_t numFrames) {
+        const synth_float_t first = frequencies[0];
+        bool constant = true;
+        for (int32_t i = 1; i < numFrames; i++) {
+            constant &= (frequencies[i] == first);
+        }
+        return constant;
+    }
+
+    void lookup(synth_float_t frequency, synth_float_t samplePeriod,
+                synth_float_t halfInverseQ,
+                BiquadCoefficients *coefficients) const {
+        synth_float_t oneMinusCosine;
+        synth_float_t sine;
+        mTable->lookup(clampFrequency(frequency) * samplePeriod,
+                       &oneMinusCosine, &sine);
+        coefficients->setLowpass(oneMinusCosine, sine, halfInverseQ);
+    }
+
+    const BiquadTrigTable *mTable;
+    synth_float_t mQ = 1.0;
+    // Coefficients at the end of the last block.
+    BiquadCoefficients mCurrent;
+    bool mStarted = false;
+    // mCurrent is for a fixed cutoff and Q.
+    bool mCached = false;
+    synth_float_t mCachedFrequency = 0;
+    synth_float_t mCachedQ = 0;
+};
+
+#endif // SYNTHMARK_BIQUAD_COEFFICIENTS_H
@@ -25,11 +25,8 @@
 #include <math.h>
 #include "SynthMark.h"
 #include "UnitGenerator.h"
-
-#define BIQUAD_MIN_FREQ      (0.00001f) // REVIEW
-#define BIQUAD_MIN_Q         (0.00001f) // REVIEW
-
-#define RECALCULATE_PER_SAMPLE   0
+#include "DenormalGuard.h"
+#include "BiquadCoefficients.h"
 
 /**
  * Time varying lowpass resonant filter.
@@ -38,10 +35,8 @@ class BiquadFilter : public UnitGenerator
 {
 public:
     BiquadFilter()
-    : mQ(1.0)
     {
         xn1 = xn2 = yn1 = yn2 = (synth_float_t) 0;
-        a0 = a1 = a2 = b1 = b2 = (synth_float_t) 0;
     }
 
     virtual ~BiquadFilter() = default;
@@ -51,110 +46,83 @@ public:
      * Input will clipped at a BIQUAD_MIN_Q.
      */
     void setQ(synth_float_t q) {
-        if( q < BIQUAD_MIN_Q ) {
-            q = BIQUAD_MIN_Q;
-        }
-        mQ = q;
+        mCoefficientEngine.setQ(q);
     }
 
     synth_float_t getQ() {
-        return mQ;
+        return mCoefficientEngine.getQ();
+    }
+
+    /**
+     * Clear the delay lines, as if the filter had been fed silence until its
+     * tail died away.
+     */
+    void reset() {
+        xn1 = xn2 = (synth_float_t) 0;
+        yn1 = yn2 = 0.0;
+    }
+
+    /**
+     * @param frequencies cutoff in Hz for each sample, see
+     *     BiquadCoefficientEngine for how a moving cutoff is followed
+     */
+    void generate(const synth_float_t *input,
+                  const synth_float_t *frequencies,
+                  int32_t numSamples) {
+        generate(input, ControlBlock::audio(frequencies), numSamples);
     }
 
-    void generate(synth_float_t *input,
-                  synth_float_t *frequencies,
+    /**
+     * @param frequency cutoff in Hz
+     */
+    void generate(const synth_float_t *input,
+                  const ControlBlock &frequency,
                   int32_t numSamples) {
-        synth_float_t xn, yn;
-
-#if RECALCULATE_PER_SAMPLE == 0
-        calculateCoefficients(frequencies[0], mQ);
-#endif
-        for (int i = 0; i < numSamples; i++) {
-#if RECALCULATE_PER_SAMPLE == 1
-                calculateCoefficients(frequencies[i], mQ);
-#endif
-            // Generate outputs by filtering inputs.
-            xn = input[i];
-            synth_float_t finite = (a0 * xn) + (a1 * xn1) + (a2 * xn2);
-            // Use double precision for recursive portion.
-            yn = finite - (b1 * yn1) - (b2 * yn2);
-            output[i] = (synth_float_t) yn;
-
-            // Delay input and output values.
-            xn2 = xn1;
-            xn1 = xn;
-            yn2 = yn1;
-            yn1 = yn;
-        }
-
-        // Apply a small bipolar impulse to filter to prevent arithmetic underflow.
-        yn1 += (synth_float_t) 1.0E-26;
-        yn2 -= (synth_float_t) 1.0E-26;
+        mCoefficientEngine.forEachSegment(frequency, numSamples,
+                getSamplePeriod(),
+                [&](int32_t start, int32_t count, BiquadCoefficients c,
+                    const BiquadCoefficients *delta) {
+            if (delta == nullptr) {
+                for (int i = start; i < start + count; i++) {
+                    output[i] = filterSample(c, input[i]);
+                }
+            } else {
+                for (int i = start; i < start + count; i++) {
+                    c.add(*delta);
+                    output[i] = filterSample(c, input[i]);
+                }
+            }
+        });
+
+        // Keep the decaying recursion out of the denormal range.
+        yn1 = DenormalGuard::flush(yn1);
+        yn2 = DenormalGuard::flush(yn2);
+        countOutput(numSamples);
     }
 
 
 private:
-    synth_float_t      mQ;
+    SYNTHMARK_ALWAYS_INLINE synth_float_t filterSample(
+            const BiquadCoefficients &c, synth_float_t xn) {
+        // Generate outputs by filtering inputs.
+        synth_float_t finite = (c.a0 * xn) + (c.a1 * xn1) + (c.a2 * xn2);
+        // Use double precision for recursive portion.
+        synth_float_t yn = finite - (c.b1 * yn1) - (c.b2 * yn2);
+
+        // Delay input and output values.
+        xn2 = xn1;
+        xn1 = xn;
+        yn2 = yn1;
+        yn1 = yn;
+        return yn;
+    }
+
+    BiquadCoefficientEngine mCoefficientEngine;
 
     synth_float_t      xn1;    // delay lines
     synth_float_t      xn2;
     double             yn1;
     double             yn2;
-
-    synth_float_t      a0;    // coefficients
-    synth_float_t      a1;
-    synth_float_t      a2;
-
-    synth_float_t      b1;
-    synth_float_t      b2;
-
-    synth_float_t      cos_omega;
-    synth_float_t      sin_omega;
-    synth_float_t      alpha;
-
-    // Calculate coefficients common to many parametric biquad filters.
-    void calcCommon( synth_float_t ratio, synth_float_t Q )
-    {
-        synth_float_t omega;
-
-        /* Don't let frequency get too close to Nyquist or filter will blow up. */
-        if( ratio >= 0.499f ) ratio = 0.499f;
-        omega = 2.0f * (synth_float_t)M_PI * ratio;
-
-#if 1
-        // This is not significantly faster on Mac or Linux.
-        cos_omega = SynthTools::fastCosine(omega);
-        sin_omega = SynthTools::fastSine(omega );
-#else
-        {
-            float fsin_omega;
-            float fcos_omega;
-            sincosf(omega, &fsin_omega, &fcos_omega);
-            cos_omega = (synth_float_t) fcos_omega;
-            sin_omega = (synth_float_t) fsin_omega;
-        }
-#endif
-        alpha = sin_omega / (2.0f * Q);
-    }
-
-    // Lowpass coefficients
-    void calculateCoefficients( synth_float_t frequency, synth_float_t Q )
-    {
-        synth_float_t    scalar, omc;
-
-        if( frequency  < BIQUAD_MIN_FREQ )  frequency  = BIQUAD_MIN_FREQ;
-
-        calcCommon( frequency * mSamplePeriod, Q );
-
-        scalar = 1.0f / (1.0f + alpha);
-        omc = (1.0f - cos_omega);
-
-        a0 = omc * 0.5f * scalar;
-        a1 = omc * scalar;
-        a2 = a0;
-        b1 = -2.0f * cos_omega * scalar;
-        b2 = (1.0f - alpha) * scalar;
-    }
 };
 
 #endif // SYNTHMARK_BIQUAD_FILTER_H
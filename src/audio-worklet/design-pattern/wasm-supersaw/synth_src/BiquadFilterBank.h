@@ -0,0 +1,199 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_BIQUAD_FILTER_BANK_H
+#define SYNTHMARK_BIQUAD_FILTER_BANK_H
+
+#include <cstdint>
+#include <assert.h>
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "UnitGenerator.h"
+#include "DenormalGuard.h"
+#include "BiquadCoefficients.h"
+
+#define BIQUAD_BANK_MAX_FILTERS  8
+
+/**
+ * A set of independent lowpass biquads, one per SIMD lane, for example the
+ * same filter stage of several voices.
+ *
+ * Audio is interleaved: sample i of lane n is at [i * kNumLanes + n]. Use
+ * interleave() and deinterleave() to convert from one buffer per lane.
+ *
+ * Each lane uses the same coefficients as a BiquadFilter with the same
+ * cutoff and Q, but the recursion runs in single precision, so the output
+ * is close to BiquadFilter but not bit identical.
+ */
+class BiquadFilterBank : public UnitGenerator
+{
+public:
+    // Lanes are padded to a whole number of SIMD vectors.
+    static constexpr int32_t kNumVectors =
+            (BIQUAD_BANK_MAX_FILTERS + SimdFloat::kWidth - 1)
+            / SimdFloat::kWidth;
+    static constexpr int32_t kNumLanes = kNumVectors * SimdFloat::kWidth;
+
+    BiquadFilterBank() {
+        for (int32_t lane = 0; lane < kNumLanes; lane++) {
+            mA0[lane] = mA1[lane] = mA2[lane] = 0;
+            mB1[lane] = mB2[lane] = 0;
+            reset(lane);
+        }
+    }
+
+    virtual ~BiquadFilterBank() = default;
+
+    /**
+     * @param frequency cutoff in Hz
+     * @param q resonance, clipped at BIQUAD_MIN_Q
+     */
+    void setLowpass(int32_t lane, synth_float_t frequency, synth_float_t q) {
+        assert(lane >= 0 && lane < kNumLanes);
+        if (frequency < BIQUAD_MIN_FREQ) {
+            frequency = BIQUAD_MIN_FREQ;
+        }
+        if (q < BIQUAD_MIN_Q) {
+            q = BIQUAD_MIN_Q;
+        }
+        BiquadCoefficients c;
+        c.setLowpass(frequency * getSamplePeriod(), q);
+        mA0[lane] = c.a0;
+        mA1[lane] = c.a1;
+        mA2[lane] = c.a2;
+        mB1[lane] = c.b1;
+        mB2[lane] = c.b2;
+    }
+
+    /**
+     * Clear the delay lines of both stages of a lane.
+     */
+    void reset(int32_t lane) {
+        for (int32_t stage = 0; stage < kNumStages; stage++) {
+            mX1[stage][lane] = mX2[stage][lane] = 0;
+            mY1[stage][lane] = mY2[stage][lane] = 0;
+        }
+    }
+
+    /**
+     * Run one biquad per lane. Input and output may be the same buffer.
+     */
+    void generate(const synth_float_t *input, synth_float_t *output,
+                  int32_t numFrames) {
+        process<1>(input, output, numFrames);
+    }
+
+    /**
+     * Run two biquads in series per lane, both with the lane's coefficients.
+     * This matches two BiquadFilters in series, see BiquadCascade, with the
+     * state of both stages kept in registers for the whole block.
+     */
+    void generateCascade(const synth_float_t *input, synth_float_t *output,
+                         int32_t numFrames) {
+        process<2>(input, output, numFrames);
+    }
+
+    static void interleave(int32_t lane, const synth_float_t *input,
+                           synth_float_t *interleaved, int32_t numFrames) {
+        for (int32_t i = 0; i < numFrames; i++) {
+            interleaved[i * kNumLanes + lane] = input[i];
+        }
+    }
+
+    static void deinterleave(int32_t lane, const synth_float_t *interleaved,
+                             synth_float_t *output, int32_t numFrames) {
+        for (int32_t i = 0; i < numFrames; i++) {
+            output[i] = interleaved[i * kNumLanes + lane];
+        }
+    }
+
+private:
+    static constexpr int32_t kNumStages = 2;
+
+    template <int32_t kStages>
+    void process(const synth_float_t *input, synth_float_t *output,
+                 int32_t numFrames) {
+        SimdFloat a0[kNumVectors];
+        SimdFloat a1[kNumVectors];
+        SimdFloat a2[kNumVectors];
+        SimdFloat b1[kNumVectors];
+        SimdFloat b2[kNumVectors];
+        SimdFloat x1[kStages][kNumVectors];
+        SimdFloat x2[kStages][kNumVectors];
+        SimdFloat y1[kStages][kNumVectors];
+        SimdFloat y2[kStages][kNumVectors];
+        for (int32_t v = 0; v < kNumVectors; v++) {
+            const int32_t lane = v * SimdFloat::kWidth;
+            a0[v] = SimdFloat::load(mA0 + lane);
+            a1[v] = SimdFloat::load(mA1 + lane);
+            a2[v] = SimdFloat::load(mA2 + lane);
+            b1[v] = SimdFloat::load(mB1 + lane);
+            b2[v] = SimdFloat::load(mB2 + lane);
+            for (int32_t stage = 0; stage < kStages; stage++) {
+                x1[stage][v] = SimdFloat::load(mX1[stage] + lane);
+                x2[stage][v] = SimdFloat::load(mX2[stage] + lane);
+                y1[stage][v] = SimdFloat::load(mY1[stage] + lane);
+                y2[stage][v] = SimdFloat::load(mY2[stage] + lane);
+            }
+        }
+
+        for (int32_t i = 0; i < numFrames; i++) {
+            const synth_float_t *in = input + i * kNumLanes;
+            synth_float_t *out = output + i * kNumLanes;
+            for (int32_t v = 0; v < kNumVectors; v++) {
+                SimdFloat x = SimdFloat::load(in + v * SimdFloat::kWidth);
+                for (int32_t stage = 0; stage < kStages; stage++) {
+                    SimdFloat y = (a0[v] * x) + (a1[v] * x1[stage][v])
+                            + (a2[v] * x2[stage][v])
+                            - (b1[v] * y1[stage][v])
+                            - (b2[v] * y2[stage][v]);
+                    x2[stage][v] = x1[stage][v];
+                    x1[stage][v] = x;
+                    y2[stage][v] = y1[stage][v];
+                    y1[stage][v] = y;
+                    x = y;
+                }
+                x.store(out + v * SimdFloat::kWidth);
+            }
+        }
+
+        // Same flush as BiquadFilter to keep the recursion out of the
+        // denormal range.
+        const SimdFloat threshold =
+                SimdFloat::broadcast(DenormalGuard::kFlushThreshold);
+        for (int32_t v = 0; v < kNumVectors; v++) {
+            const int32_t lane = v * SimdFloat::kWidth;
+            for (int32_t stage = 0; stage < kStages; stage++) {
+                x1[stage][v].store(mX1[stage] + lane);
+                x2[stage][v].store(mX2[stage] + lane);
+                y1[stage][v].zeroIfSmaller(threshold).store(mY1[stage] + lane);
+                y2[stage][v].zeroIfSmaller(threshold).store(mY2[stage] + lane);
+            }
+        }
+    }
+
+    alignas(32) synth_float_t mA0[kNumLanes];    // coefficients
+    alignas(32) synth_float_t mA1[kNumLanes];
+    alignas(32) synth_float_t mA2[kNumLanes];
+    alignas(32) synth_float_t mB1[kNumLanes];
+    alignas(32) synth_float_t mB2[kNumLanes];
+    alignas(32) synth_float_t mX1[kNumStages][kNumLanes];    // delay lines
+    alignas(32) synth_float_t mX2[kNumStages][kNumLanes];
+    alignas(32) synth_float_t mY1[kNumStages][kNumLanes];
+    alignas(32) synth_float_t mY2[kNumStages][kNumLanes];
+};
+
+#endif // SYNTHMARK_BIQUAD_FILTER_BANK_H
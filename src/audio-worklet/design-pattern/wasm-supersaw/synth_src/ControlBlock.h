@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_CONTROL_BLOCK_H
+#define SYNTHMARK_CONTROL_BLOCK_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "SynthTools.h"
+
+/**
+ * The values of a control input, such as a frequency or a cutoff, for one
+ * block.
+ *
+ * Most controls hold still or move in a straight line for a whole block, so
+ * a generator can check the mode and skip the per sample work:
+ *   CONSTANT  every sample is value
+ *   RAMP      sample i is value + (i * increment)
+ *   AUDIO     sample i is samples[i]
+ */
+struct ControlBlock
+{
+    enum Mode {
+        CONSTANT, RAMP, AUDIO
+    };
+
+    Mode mode = CONSTANT;
+    synth_float_t value = 0;
+    synth_float_t increment = 0;
+    const synth_float_t *samples = nullptr;
+
+    static ControlBlock constant(synth_float_t value) {
+        ControlBlock block;
+        block.value = value;
+        return block;
+    }
+
+    static ControlBlock ramp(synth_float_t start, synth_float_t increment) {
+        ControlBlock block;
+        block.mode = RAMP;
+        block.value = start;
+        block.increment = increment;
+        return block;
+    }
+
+    /**
+     * @param samples must stay valid while the block is used
+     */
+    static ControlBlock audio(const synth_float_t *samples) {
+        ControlBlock block;
+        block.mode = AUDIO;
+        block.samples = samples;
+        return block;
+    }
+
+    bool isConstant() const {
+        return mode == CONSTANT;
+    }
+
+    synth_float_t getValue(int32_t index) const {
+        switch (mode) {
+            case CONSTANT:
+                return value;
+            case RAMP:
+                return value + ((synth_float_t) index * increment);
+            case AUDIO:
+            default:
+                return samples[index];
+        }
+    }
+
+    /**
+     * @return the samples of the block, written to buffer unless the block
+     *     is already AUDIO
+     */
+    const synth_float_t *render(synth_float_t *buffer, int32_t numFrames) const {
+        switch (mode) {
+            case CONSTANT:
+                SynthTools::fillBuffer(buffer, numFrames, value);
+                return buffer;
+            case RAMP:
+                SynthTools::fillRamp(buffer, numFrames, value, increment);
+                return buffer;
+            case AUDIO:
+            default:
+                return samples;
+        }
+    }
+
+    /**
+     * @return this + (other * gain). The result stays CONSTANT or RAMP when
+     *     both inputs are, otherwise it is written to buffer.
+     */
+    ControlBlock addScaled(const ControlBlock &other, synth_float_t gain,
+                           synth_float_t *buffer, int32_t numFrames) const {
+        if (mode != AUDIO && other.mode != AUDIO) {
+            if (mode == CONSTANT && other.mode == CONSTANT) {
+                return constant(value + (other.value * gain));
+            }
+            return ramp(value + (other.value * gain),
+                        increment + (other.increment * gain));
+        }
+        if (mode == AUDIO && other.mode == AUDIO) {
+            SynthTools::mixBuffers(samples, 1.0f, other.samples, gain, buffer,
+                                   numFrames);
+        } else if (mode == AUDIO) {
+            other.render(buffer, numFrames);
+            SynthTools::mixBuffers(samples, 1.0f, buffer, gain, buffer,
+                                   numFrames);
+        } else {
+            render(buffer, numFrames);
+            SynthTools::addBuffers(other.samples, gain, buffer, numFrames);
+        }
+        return audio(buffer);
+    }
+};
+
+#endif // SYNTHMARK_CONTROL_BLOCK_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_DENORMAL_GUARD_H
+#define SYNTHMARK_DENORMAL_GUARD_H
+
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+#include "SynthMark.h"
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define SYNTHMARK_HARDWARE_FLUSH  1
+#elif defined(__aarch64__)
+#define SYNTHMARK_HARDWARE_FLUSH  1
+#else
+// Eg. wasm, which has no floating point control register.
+#define SYNTHMARK_HARDWARE_FLUSH  0
+#endif
+
+/**
+ * Denormal numbers are 1000 times or more slower than normal ones on many
+ * CPUs. They show up in the recursive state of filters as a note decays, and
+ * cause CPU spikes long after the sound is inaudible.
+ *
+ * There are two defenses:
+ *  - ScopedDenormalGuard makes the CPU flush denormals to zero, on x86 and
+ *    ARM64. Synthesizer::render() and the render threads hold one.
+ *  - flush() is a software equivalent for generators with feedback. They
+ *    call it on their state once per block. It is the only defense in wasm,
+ *    which cannot change the floating point mode.
+ */
+class DenormalGuard
+{
+public:
+    // Recursive state below this, about -400 dB, is set to zero. It is far
+    // above the denormal range, so slowly decaying state is cleared long
+    // before it gets there.
+    static constexpr synth_float_t kFlushThreshold = 1.0e-20f;
+
+    static constexpr bool kHasHardwareFlush = SYNTHMARK_HARDWARE_FLUSH;
+
+    /**
+     * @return zero if x is below kFlushThreshold in magnitude, or NaN
+     */
+    static synth_float_t flush(synth_float_t x) {
+        return (fabsf(x) >= kFlushThreshold) ? x : 0.0f;
+    }
+
+    static double flush(double x) {
+        return (fabs(x) >= kFlushThreshold) ? x : 0.0;
+    }
+};
+
+/**
+ * Flushes denormal results and inputs to zero on the calling thread until
+ * destroyed, then restores the previous mode. Guards may be nested. Does
+ * nothing where kHasHardwareFlush is false.
+ */
+class ScopedDenormalGuard
+{
+public:
+    ScopedDenormalGuard() {
+#if defined(__SSE__) || defined(__x86_64__)
+        // Flush to zero (FTZ) and denormals are zero (DAZ).
+        mSavedMode = _mm_getcsr();
+        _mm_setcsr(mSavedMode | 0x8040);
+#elif defined(__aarch64__)
+        uint64_t mode;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+        mSavedMode = mode;
+        // FZ flushes both inputs and results.
+        mode |= (1 << 24);
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+#endif
+    }
+
+    ~ScopedDenormalGuard() {
+#if defined(__SSE__) || defined(__x86_64__)
+        _mm_setcsr((unsigned int) mSavedMode);
+#elif defined(__aarch64__)
+        uint64_t mode = mSavedMode;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+#endif
+    }
+
+    ScopedDenormalGuard(const ScopedDenormalGuard &) = delete;
+    ScopedDenormalGuard &operator=(const ScopedDenormalGuard &) = delete;
+
+private:
+    uint64_t mSavedMode = 0;
+};
+
+/**
+ * Counts of unhealthy samples in the output of a generator, see
+ * UnitGenerator::setSampleCounters(). Counting is opt-in because it reads
+ * every sample again.
+ */
+struct SampleCounters
+{
+    int64_t samples = 0;
+    int64_t denormals = 0;
+    // NaN or infinity
+    int64_t nonFinite = 0;
+
+    void count(const synth_float_t *buffer, int32_t numSamples) {
+        // Test the exponent bits, so this works when the CPU flushes
+        // denormals, and vectorizes.
+        int32_t denormalCount = 0;
+        int32_t nonFiniteCount = 0;
+        for (int32_t i = 0; i < numSamples; i++) {
+            uint32_t bits;
+            memcpy(&bits, &buffer[i], sizeof(bits));
+            const uint32_t exponent = bits & 0x7f800000;
+            denormalCount += (exponent == 0) & ((bits & 0x007fffff) != 0);
+            nonFiniteCount += (exponent == 0x7f800000);
+        }
+        samples += numSamples;
+        denormals += denormalCount;
+        nonFinite += nonFiniteCount;
+    }
+
+    void add(const SampleCounters &other) {
+        samples += other.samples;
+        denormals += other.denormals;
+        nonFinite += other.nonFinite;
+    }
+
+    void reset() {
+        samples = 0;
+        denormals = 0;
+        nonFinite = 0;
+    }
+};
+
+#endif // SYNTHMARK_DENORMAL_GUARD_H
@@ -26,7 +26,8 @@
 #include "SynthMark.h"
 //#include "tools/SynthTools.h"
 
-#define DPW_VERY_LOW_FREQUENCY (2.0 * 0.1 / SYNTHMARK_SAMPLE_RATE)
+// Frequency in Hz below which a raw sawtooth is used instead of DPW.
+#define DPW_VERY_LOW_FREQUENCY 0.1
 
 /**
  * DPW is a tool for generating band-limited waveforms
@@ -42,15 +43,21 @@ public:
 
     virtual ~DifferentiatedParabola() = default;
 
-    synth_float_t next(synth_float_t phase, synth_float_t phaseIncrement) {
+    /**
+     * @param veryLowIncrement phase increment of DPW_VERY_LOW_FREQUENCY,
+     *     see EngineContext::getDpwVeryLowIncrement()
+     */
+    synth_float_t next(synth_float_t phase,
+                       synth_float_t phaseIncrement,
+                       synth_float_t veryLowIncrement) {
         synth_float_t dpw;
         synth_float_t positivePhaseIncrement = (phaseIncrement < 0.0)
-                ? phaseIncrement
-                : 0.0 - phaseIncrement;
+                ? 0.0 - phaseIncrement
+                : phaseIncrement;
 
         // If the frequency is very low then just use the raw sawtooth.
         // This avoids divide by zero problems and scaling problems.
-        if (positivePhaseIncrement < DPW_VERY_LOW_FREQUENCY) {
+        if (positivePhaseIncrement < veryLowIncrement) {
             dpw = phase;
         } else {
             // Calculate the parabola.
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_ENGINE_CONTEXT_H
+#define SYNTHMARK_ENGINE_CONTEXT_H
+
+#include <cstdint>
+#include <assert.h>
+#include "SynthMark.h"
+#include "DifferentiatedParabola.h"
+
+/**
+ * State shared by all of the unit generators of one engine, eg. one
+ * Synthesizer. Each engine owns its own context so that engines with
+ * different sample rates can run side by side, on separate threads.
+ */
+class EngineContext
+{
+public:
+    explicit EngineContext(int32_t sampleRate = SYNTHMARK_SAMPLE_RATE)
+        : mSampleRate(sampleRate)
+        , mSamplePeriod(1.0f / sampleRate)
+        , mDpwVeryLowIncrement(2.0 * DPW_VERY_LOW_FREQUENCY / sampleRate) {
+        assert(sampleRate > 0);
+    }
+
+    int32_t getSampleRate() const {
+        return mSampleRate;
+    }
+
+    synth_float_t getSamplePeriod() const {
+        return mSamplePeriod;
+    }
+
+    /**
+     * @return phase increment below which DPW falls back to a raw sawtooth
+     */
+    synth_float_t getDpwVeryLowIncrement() const {
+        return mDpwVeryLowIncrement;
+    }
+
+    int32_t getFramesPerBlock() const {
+        return mFramesPerBlock;
+    }
+
+    void setFramesPerBlock(int32_t framesPerBlock) {
+        assert(framesPerBlock > 0
+                && framesPerBlock <= SYNTHMARK_MAX_FRAMES_PER_RENDER);
+        mFramesPerBlock = framesPerBlock;
+    }
+
+private:
+    const int32_t mSampleRate;
+    const synth_float_t mSamplePeriod;
+    const synth_float_t mDpwVeryLowIncrement;
+    int32_t mFramesPerBlock = SYNTHMARK_FRAMES_PER_RENDER;
+};
+
+#endif // SYNTHMARK_ENGINE_CONTEXT_H
@@ -24,6 +24,8 @@
 #include <cstdint>
 #include <math.h>
 #include "SynthMark.h"
+#include "SynthTools.h"
+#include "ControlBlock.h"
 #include "UnitGenerator.h"
 
 /**
@@ -31,8 +33,6 @@
  * other parameters.
  */
 
-const int32_t kSampleRate = 48000;
-
 class EnvelopeADSR  : public UnitGenerator
 {
 public:
@@ -63,12 +63,29 @@ public:
         return !isIdle() || triggered;
     }
 
+    bool isGateOn() {
+        return triggered;
+    }
+
+    synth_float_t getLevel() {
+        return mLevel;
+    }
+
+    /**
+     * Jump to IDLE with the gate off. Used when a voice is stolen.
+     */
+    void reset() {
+        triggered = false;
+        startIdle();
+    }
+
     /**
      * Time in seconds for the rising stage of the envelope to go from 0.0 to 1.0. The attack is a
      * linear ramp.
      */
     void setAttackTime(synth_float_t time) {
         mAttack = time;
+        mRatesSampleRate = 0;
     }
 
     synth_float_t getAttackTime() {
@@ -82,6 +99,7 @@ public:
      */
     void setDecayTime(synth_float_t time) {
         mDecay = time;
+        mRatesSampleRate = 0;
     }
 
     synth_float_t getDecayTime() {
@@ -103,93 +121,190 @@ public:
 
     void setReleaseTime(synth_float_t time){
         mRelease = time;
+        mRatesSampleRate = 0;
     }
 
     synth_float_t getReleaseTime() {
         return mRelease;
     }
 
+    /**
+     * Fill the output one segment at a time. The number of samples left in
+     * the current stage is calculated up front, then the whole run is
+     * filled with a linear or exponential ramp. The gate is only looked at
+     * when a segment starts, since it cannot change inside a block.
+     */
     void generate(int32_t numSamples) {
-        for (int i = 0; i < numSamples; i++) {
+        if (mRatesSampleRate != getSampleRate()) {
+            updateRates();
+        }
+        int32_t i = 0;
+        mOutputConstant = false;
+        while (i < numSamples) {
             switch (mState) {
                 case IDLE:
-                    for (; i < numSamples; i++) {
-                        output[i] = mLevel;
-                        if (triggered) {
-                            startAttack();
-                            break;
-                        }
+                    if (triggered) {
+                        startAttack();
+                    } else {
+                        SynthTools::fillBuffer(output + i, numSamples - i, mLevel);
+                        mOutputConstant = (i == 0);
+                        i = numSamples;
                     }
                     break;
 
                 case ATTACKING:
-                    for (; i < numSamples; i++) {
-                        // Increment first so we can render fast attacks.
-                        mLevel += increment;
-                        if (mLevel >= 1.0) {
-                            mLevel = 1.0;
-                            output[i] = mLevel;
-                            startDecay();
-                            break;
-                        } else {
-                            output[i] = mLevel;
-                            if (!triggered) {
-                                startRelease();
-                                break;
-                            }
-                        }
+                    if (!triggered) {
+                        startRelease();
+                    } else {
+                        i += generateAttack(output + i, numSamples - i);
                     }
                     break;
 
                 case DECAYING:
-                    for (; i < numSamples; i++) {
-                        output[i] = mLevel;
-                        mLevel *= mScaler; // exponential decay
-                        if (mLevel < SYNTHMARK_DB96) {
-                            startIdle();
-                            break;
-                        } else if (!triggered) {
-                            startRelease();
-                            break;
-                        } else if (mLevel < mSustainLevel) {
-                            mLevel = mSustainLevel;
-                            startSustain();
-                            break;
-                        }
+                    if (!triggered) {
+                        startRelease();
+                    } else {
+                        i += generateDecay(output + i, numSamples - i);
                     }
                     break;
 
                 case SUSTAINING:
-                    for (; i < numSamples; i++) {
+                    if (!triggered) {
+                        startRelease();
+                    } else {
                         mLevel = mSustainLevel;
-                        output[i] = mLevel;
-                        if (!triggered) {
-                            startRelease();
-                            break;
-                        }
+                        SynthTools::fillBuffer(output + i, numSamples - i, mLevel);
+                        mOutputConstant = (i == 0);
+                        i = numSamples;
                     }
                     break;
 
                 case RELEASING:
-                    for (; i < numSamples; i++) {
-                        output[i] = mLevel;
-                        mLevel *= mScaler; // exponential decay
-                        // mLevel *= 0;
-                        if (triggered) {
-                            startAttack();
-                            break;
-                        } else if (mLevel < SYNTHMARK_DB96) {
-                            startIdle();
-                            break;
-                        }
+                    if (triggered) {
+                        startAttack();
+                    } else {
+                        i += generateRelease(output + i, numSamples - i);
                     }
                     break;
             }
         }
+        countOutput(numSamples);
+    }
+
+    /**
+     * The output of the last generate(). It is CONSTANT when the envelope
+     * was idle or sustaining for the whole block.
+     */
+    ControlBlock getOutput() const {
+        return mOutputConstant ? ControlBlock::constant(output[0])
+                               : ControlBlock::audio(output);
     }
 
 private:
 
+    /**
+     * Linear ramp up to 1.0. The level is incremented before it is output so
+     * that fast attacks are rendered.
+     * @return number of samples written
+     */
+    int32_t generateAttack(synth_float_t *buffer, int32_t numSamples) {
+        // Number of increments until the level reaches 1.0.
+        double steps = (1.0 - mLevel) / mAttackIncrement;
+        if (steps > numSamples) {
+            SynthTools::fillRamp(buffer, numSamples, mLevel + mAttackIncrement,
+                                 mAttackIncrement);
+            mLevel += numSamples * mAttackIncrement;
+            return numSamples;
+        }
+        int32_t count = (steps < 1.0) ? 1 : (int32_t) ceil(steps);
+        SynthTools::fillRamp(buffer, count - 1, mLevel + mAttackIncrement,
+                             mAttackIncrement);
+        mLevel = 1.0;
+        buffer[count - 1] = mLevel;
+        startDecay();
+        return count;
+    }
+
+    /**
+     * Exponential decay towards the sustain level, or to silence if the
+     * sustain level is below SYNTHMARK_DB96.
+     * @return number of samples written
+     */
+    int32_t generateDecay(synth_float_t *buffer, int32_t numSamples) {
+        bool toSustain = mSustainLevel >= SYNTHMARK_DB96;
+        synth_float_t target = toSustain ? mSustainLevel : SYNTHMARK_DB96;
+        int32_t count = generateExponential(buffer, numSamples, mDecayScaler,
+                                            mDecayInverseLog, target);
+        if (mLevel < target) {
+            if (toSustain) {
+                mLevel = mSustainLevel;
+                startSustain();
+            } else {
+                startIdle();
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Exponential decay to silence.
+     * @return number of samples written
+     */
+    int32_t generateRelease(synth_float_t *buffer, int32_t numSamples) {
+        int32_t count = generateExponential(buffer, numSamples, mReleaseScaler,
+                                            mReleaseInverseLog, SYNTHMARK_DB96);
+        if (mLevel < SYNTHMARK_DB96) {
+            startIdle();
+        }
+        return count;
+    }
+
+    /**
+     * Output the level and multiply it by the scaler until it falls below
+     * the target or the buffer is full.
+     * @param inverseLog 1 / log(scaler)
+     * @return number of samples written
+     */
+    int32_t generateExponential(synth_float_t *buffer, int32_t numSamples,
+                                synth_float_t scaler, double inverseLog,
+                                synth_float_t target) {
+        int32_t count = numSamples;
+        if (mLevel < target) {
+            count = 1;
+        } else {
+            // level * scaler^n < target when n > log(target / level) / log(scaler)
+            double steps = floor(log(target / mLevel) * inverseLog) + 1.0;
+            if (steps < numSamples) {
+                count = (steps < 1.0) ? 1 : (int32_t) steps;
+            }
+        }
+        mLevel = SynthTools::fillGeometric(buffer, count, mLevel, scaler);
+        return count;
+    }
+
+    /**
+     * Convert the stage times to per sample rates. Called when a time or the
+     * sample rate changes, not when a stage starts.
+     */
+    void updateRates() {
+        const int32_t sampleRate = getSampleRate();
+        mAttackIncrement = (mAttack < MIN_DURATION)
+                ? 1.0f : (synth_float_t) (1.0 / (mAttack * sampleRate));
+        mDecayScaler = (mDecay < MIN_DURATION)
+                ? 0.0f : calculateScaler(mDecay, sampleRate, &mDecayInverseLog);
+        synth_float_t release = (mRelease < MIN_DURATION) ? MIN_DURATION : mRelease;
+        mReleaseScaler = calculateScaler(release, sampleRate, &mReleaseInverseLog);
+        mRatesSampleRate = sampleRate;
+    }
+
+    static synth_float_t calculateScaler(synth_float_t duration, int32_t sampleRate,
+                                         double *inverseLog) {
+        synth_float_t scaler = (synth_float_t)
+                SynthTools::convertTimeToExponentialScaler(duration, sampleRate);
+        *inverseLog = 1.0 / log((double) scaler);
+        return scaler;
+    }
+
     void startIdle() {
         mState = State::IDLE;
         mLevel = 0.0;
@@ -200,17 +315,14 @@ private:
             mLevel = 1.0;
             startDecay();
         } else {
-            increment = mSamplePeriod / mAttack;
             mState = State::ATTACKING;
         }
     }
 
     void startDecay() {
-        double duration = mDecay;
-        if (duration < MIN_DURATION) {
+        if (mDecay < MIN_DURATION) {
             startSustain();
         } else {
-            mScaler = SynthTools::convertTimeToExponentialScaler(duration, kSampleRate);
             mState = State::DECAYING;
         }
     }
@@ -220,11 +332,6 @@ private:
     }
 
     void startRelease() {
-        double duration = mRelease;
-        if (duration < MIN_DURATION) {
-            duration = MIN_DURATION;
-        }
-        mScaler = SynthTools::convertTimeToExponentialScaler(duration, kSampleRate);
         mState = State::RELEASING;
     }
 
@@ -244,10 +351,18 @@ private:
     synth_float_t mRelease;
 
     State mState = State::IDLE;
-    synth_float_t mScaler = 1.0;
     synth_float_t mLevel = 0.0;
-    synth_float_t increment = 0;
     bool triggered = false;
+    bool mOutputConstant = false;
+
+    // Per sample rates derived from the stage times, see updateRates().
+    // A sample rate of zero means they need to be recalculated.
+    int32_t mRatesSampleRate = 0;
+    synth_float_t mAttackIncrement = 1.0;
+    synth_float_t mDecayScaler = 0.0;
+    double mDecayInverseLog = 0.0;
+    synth_float_t mReleaseScaler = 0.0;
+    double mReleaseInverseLog = 0.0;
 
 };
 
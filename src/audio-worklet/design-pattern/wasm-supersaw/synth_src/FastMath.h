@@ -0,0 +1,281 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_FAST_MATH_H
+#define SYNTHMARK_FAST_MATH_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "SynthSimd.h"
+
+/**
+ * Polynomial approximations of exp2, log2, pow, sin, cos and tanh that work
+ * on a SimdFloat, a block of samples or a single float.
+ *
+ * Each function takes an Accuracy. Higher tiers use longer polynomials. The
+ * maximum errors below were measured by `make mathbench`, and
+ * test/fast_math_test.cc checks them:
+ *
+ *              FAST        MEDIUM      ACCURATE
+ *   exp2       1.0e-4      3.5e-6      1.7e-7     relative, |x| <= 20
+ *   log2       3.5e-4      8.3e-6      1.2e-6     absolute, 1e-6 <= x <= 1e6
+ *   sin        4.9e-4      1.5e-5      3.9e-6     absolute, |x| <= 100
+ *   cos        4.9e-4      1.8e-5      7.1e-6     absolute, |x| <= 100
+ *   tanh       5.0e-5      1.7e-6      1.3e-7     absolute
+ *   pow        9.4e-4      2.0e-5      1.7e-6     relative, 0.01 <= x <= 100,
+ *                                                 |y| <= 4
+ *
+ * At the ACCURATE tier most of the log2, sin and cos error is the rounding
+ * of the float result or of the range reduction, not the polynomial.
+ *
+ * Domains: exp2 clamps its input to -126 to +127.999, log2 and pow need a
+ * positive normal x, sin and cos lose precision for large |x| like any float
+ * range reduction. The single float versions run the vector code, so they
+ * match the block versions bit for bit.
+ */
+class FastMath
+{
+public:
+    enum Accuracy {
+        FAST, MEDIUM, ACCURATE
+    };
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat exp2(SimdFloat x) {
+        x = x.max(SimdFloat::broadcast(-126.0f))
+                .min(SimdFloat::broadcast(127.999f));
+        SimdFloat whole = x.floor();
+        SimdFloat fraction = x - whole;
+        SimdFloat mantissa;
+        if (kAccuracy == FAST) {
+            mantissa = polynomial(fraction, kExp2Fast);
+        } else if (kAccuracy == MEDIUM) {
+            mantissa = polynomial(fraction, kExp2Medium);
+        } else {
+            mantissa = polynomial(fraction, kExp2Accurate);
+        }
+        return mantissa * SimdFloat::powerOfTwo(whole);
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat log2(SimdFloat x) {
+        SimdFloat exponent;
+        SimdFloat mantissa = x.splitExponent(&exponent);
+        // log2(m) = t * s(t^2) with t = (m - 1) / (m + 1), from 0 to 1/3
+        const SimdFloat one = SimdFloat::broadcast(1.0f);
+        SimdFloat t = (mantissa - one) / (mantissa + one);
+        SimdFloat t2 = t * t;
+        SimdFloat series;
+        if (kAccuracy == FAST) {
+            series = polynomial(t2, kLog2Fast);
+        } else if (kAccuracy == MEDIUM) {
+            series = polynomial(t2, kLog2Medium);
+        } else {
+            series = polynomial(t2, kLog2Accurate);
+        }
+        return exponent + (t * series);
+    }
+
+    /**
+     * @return x^y for x > 0
+     */
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat pow(SimdFloat x, SimdFloat y) {
+        return exp2<kAccuracy>(y * log2<kAccuracy>(x));
+    }
+
+    /**
+     * @param x angle in radians
+     */
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat sin(SimdFloat x) {
+        // Subtract whole turns in two steps, so that the rounding of 2 pi to
+        // a float does not grow with the number of turns.
+        SimdFloat turns = ((x * SimdFloat::broadcast(kInverseTwoPi))
+                + SimdFloat::broadcast(0.5f)).floor();
+        SimdFloat r = (x - (turns * SimdFloat::broadcast(kTwoPiHigh)))
+                - (turns * SimdFloat::broadcast(kTwoPiLow));
+        // sin(r) = r * s(r^2) for r from -pi to +pi
+        SimdFloat r2 = r * r;
+        SimdFloat series;
+        if (kAccuracy == FAST) {
+            series = polynomial(r2, kSineFast);
+        } else if (kAccuracy == MEDIUM) {
+            series = polynomial(r2, kSineMedium);
+        } else {
+            series = polynomial(r2, kSineAccurate);
+        }
+        return r * series;
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat cos(SimdFloat x) {
+        return sin<kAccuracy>(x + SimdFloat::broadcast(kHalfPi));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static SimdFloat tanh(SimdFloat x) {
+        // Beyond 9 tanh rounds to 1.0 and e^2x would overflow at low tiers.
+        x = x.max(SimdFloat::broadcast(-9.0f)).min(SimdFloat::broadcast(9.0f));
+        const SimdFloat one = SimdFloat::broadcast(1.0f);
+        SimdFloat e = exp2<kAccuracy>(x * SimdFloat::broadcast(kTwoLog2E));
+        return (e - one) / (e + one);
+    }
+
+    // Single values, computed in lane 0 of a vector.
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t exp2(synth_float_t x) {
+        return firstLane(exp2<kAccuracy>(SimdFloat::broadcast(x)));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t log2(synth_float_t x) {
+        return firstLane(log2<kAccuracy>(SimdFloat::broadcast(x)));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t pow(synth_float_t x, synth_float_t y) {
+        return firstLane(pow<kAccuracy>(SimdFloat::broadcast(x),
+                                        SimdFloat::broadcast(y)));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t sin(synth_float_t x) {
+        return firstLane(sin<kAccuracy>(SimdFloat::broadcast(x)));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t cos(synth_float_t x) {
+        return firstLane(cos<kAccuracy>(SimdFloat::broadcast(x)));
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static synth_float_t tanh(synth_float_t x) {
+        return firstLane(tanh<kAccuracy>(SimdFloat::broadcast(x)));
+    }
+
+    // Blocks. The output may be the same buffer as the input.
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static void exp2(const synth_float_t *input, synth_float_t *output,
+                     int32_t numSamples) {
+        forEachVector(input, output, numSamples,
+                      [](SimdFloat x) { return exp2<kAccuracy>(x); });
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static void log2(const synth_float_t *input, synth_float_t *output,
+                     int32_t numSamples) {
+        forEachVector(input, output, numSamples,
+                      [](SimdFloat x) { return log2<kAccuracy>(x); });
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static void sin(const synth_float_t *input, synth_float_t *output,
+                    int32_t numSamples) {
+        forEachVector(input, output, numSamples,
+                      [](SimdFloat x) { return sin<kAccuracy>(x); });
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static void cos(const synth_float_t *input, synth_float_t *output,
+                    int32_t numSamples) {
+        forEachVector(input, output, numSamples,
+                      [](SimdFloat x) { return cos<kAccuracy>(x); });
+    }
+
+    template <Accuracy kAccuracy = ACCURATE>
+    static void tanh(const synth_float_t *input, synth_float_t *output,
+                     int32_t numSamples) {
+        forEachVector(input, output, numSamples,
+                      [](SimdFloat x) { return tanh<kAccuracy>(x); });
+    }
+
+private:
+    static constexpr float kHalfPi = 1.57079632679489662f;
+    static constexpr float kInverseTwoPi = 0.159154943091895336f;
+    // 2 pi split into a float and the part that the float rounds off.
+    static constexpr float kTwoPiHigh = 6.28318548202514648f;
+    static constexpr float kTwoPiLow = -1.74845553e-7f;
+    static constexpr float kTwoLog2E = 2.88539008177792681f;
+
+    // Near minimax fits, lowest order first.
+    // 2^f for f from 0 to 1
+    static constexpr float kExp2Fast[] = {
+            0.999900288f, 0.696324771f, 0.224693156f, 0.0789672570f};
+    static constexpr float kExp2Medium[] = {
+            1.00000349f, 0.692972922f, 0.241604357f, 0.0517449978f,
+            0.0136703095f};
+    static constexpr float kExp2Accurate[] = {
+            0.999999898f, 0.693154490f, 0.240141818f, 0.0558603371f,
+            0.00894959042f, 0.00189375406f};
+    // log2((1 + t) / (1 - t)) / t as a polynomial in t^2, t from 0 to 1/3
+    static constexpr float kLog2Fast[] = {
+            2.88442305f, 1.03072692f};
+    static constexpr float kLog2Medium[] = {
+            2.88541030f, 0.958537017f, 0.653137796f};
+    static constexpr float kLog2Accurate[] = {
+            2.88538962f, 0.961929162f, 0.571208926f, 0.493453920f};
+    // sin(r) / r as a polynomial in r^2, r from -pi to +pi
+    static constexpr float kSineFast[] = {
+            0.999829359f, -0.166111764f, 0.00804772815f, -0.000150250639f};
+    static constexpr float kSineMedium[] = {
+            0.999996090f, -0.166646831f, 0.00831714416f, -0.000193749518f,
+            2.19729638e-6f};
+    static constexpr float kSineAccurate[] = {
+            0.999999937f, -0.166666207f, 0.00833278847f, -0.000198175451f,
+            2.70873177e-6f, -2.06941101e-8f};
+
+    template <int32_t kNumCoefficients>
+    static SimdFloat polynomial(SimdFloat x,
+                                const float (&coefficients)[kNumCoefficients]) {
+        SimdFloat sum = SimdFloat::broadcast(coefficients[kNumCoefficients - 1]);
+        for (int32_t i = kNumCoefficients - 2; i >= 0; i--) {
+            sum = (sum * x) + SimdFloat::broadcast(coefficients[i]);
+        }
+        return sum;
+    }
+
+    static synth_float_t firstLane(SimdFloat x) {
+        alignas(32) synth_float_t lanes[SimdFloat::kWidth];
+        x.store(lanes);
+        return lanes[0];
+    }
+
+    template <typename Function>
+    static void forEachVector(const synth_float_t *input, synth_float_t *output,
+                              int32_t numSamples, Function function) {
+        int32_t i = 0;
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            function(SimdFloat::load(input + i)).store(output + i);
+        }
+        if (i < numSamples) {
+            // Pad the last vector, so the tail is computed the same way.
+            alignas(32) synth_float_t lanes[SimdFloat::kWidth] = {};
+            const int32_t remaining = numSamples - i;
+            for (int32_t lane = 0; lane < remaining; lane++) {
+                lanes[lane] = input[i + lane];
+            }
+            function(SimdFloat::load(lanes)).store(lanes);
+            for (int32_t lane = 0; lane < remaining; lane++) {
+                output[i + lane] = lanes[lane];
+            }
+        }
+    }
+};
+
+#endif // SYNTHMARK_FAST_MATH_H
@@ -23,48 +23,151 @@
 
 #include <cstdint>
 #include "SynthMark.h"
+#include "SynthSimd.h"
 
-class LookupTable {
+/**
+ * Math that the compiler can evaluate while it builds a constexpr table.
+ * The <math.h> functions are not constexpr. These are accurate to about
+ * 1e-15 but slow, so do not call them while rendering.
+ */
+class ConstexprMath
+{
 public:
-    LookupTable(int32_t numEntries)
-        : mNumEntries(numEntries)
-        {}
+    static constexpr double kPi = 3.14159265358979323846;
+    static constexpr double kLn2 = 0.69314718055994530942;
+
+    static constexpr double exp(double x) {
+        // Halve x until the series converges quickly, then square back.
+        int32_t halvings = 0;
+        while (x > 0.5 || x < -0.5) {
+            x *= 0.5;
+            halvings++;
+        }
+        double term = 1.0;
+        double sum = 1.0;
+        for (int32_t n = 1; n < 20; n++) {
+            term *= x / n;
+            sum += term;
+        }
+        for (int32_t i = 0; i < halvings; i++) {
+            sum *= sum;
+        }
+        return sum;
+    }
 
-    virtual ~LookupTable() {
-        delete[] mTable;
+    static constexpr double exp2(double x) {
+        return exp(x * kLn2);
     }
 
-    void fillTable() {
-        // Add 2 guard points for interpolation and roundoff error.
-        int tableSize = mNumEntries + 2;
-        mTable = new float[tableSize];
-        // Fill the table with calculated values
-        float scale = 1.0f / mNumEntries;
-        for (int i = 0; i < tableSize; i++) {
-            float value = calculate(i * scale);
-            mTable[i] = value;
+    static constexpr double sin(double x) {
+        // Reduce to -pi to +pi.
+        double cycles = x / (2.0 * kPi);
+        int64_t whole = (int64_t) (cycles + ((cycles < 0.0) ? -0.5 : 0.5));
+        x -= whole * (2.0 * kPi);
+        double term = x;
+        double sum = x;
+        for (int32_t n = 3; n < 40; n += 2) {
+            term *= -(x * x) / (n * (n - 1));
+            sum += term;
         }
+        return sum;
     }
 
-    /**
-     * @param input normalized between 0.0 and 1.0
-     */
-    float lookup(float input) {
-        float fractionalTableIndex = input * mNumEntries;
-        int32_t index = (int) floor(fractionalTableIndex);
-        float fraction = fractionalTableIndex - index;
-        float baseValue = mTable[index];
-        float value = baseValue
-                + (fraction * (mTable[index + 1] - baseValue));
-        return value;
+    static constexpr double tanh(double x) {
+        double e = exp(2.0 * x);
+        return (e - 1.0) / (e + 1.0);
     }
 
-    virtual float calculate(float input)  = 0;
+    // Functions of the normalized table input for the shared tables below.
+    static constexpr double powerOfTwo(double x) {
+        return exp2(x);
+    }
+
+    static constexpr double sineCycle(double x) {
+        return sin(2.0 * kPi * x);
+    }
+};
+
+/**
+ * Table of a function between minInput and maxInput that is filled in by
+ * the compiler, so there is no work at startup and nothing to allocate.
+ *
+ * Inputs outside the range are clamped to it. The block lookup() gives the
+ * same results as looking up one sample at a time, but works on a SIMD
+ * vector of inputs at a time.
+ */
+template <int32_t kNumEntries>
+class LookupTable {
+public:
+    // Guard points for interpolation and roundoff error.
+    static constexpr int32_t kGuardPoints = 2;
+
+    constexpr LookupTable(double (*function)(double),
+                          double minInput, double maxInput)
+        : mMinInput((synth_float_t) minInput)
+        , mScaler((synth_float_t) (kNumEntries / (maxInput - minInput)))
+        {
+            const double step = (maxInput - minInput) / kNumEntries;
+            for (int32_t i = 0; i < kNumEntries + kGuardPoints; i++) {
+                mTable[i] = (synth_float_t) function(minInput + (i * step));
+            }
+        }
+
+    constexpr synth_float_t lookup(synth_float_t input) const {
+        synth_float_t position = (input - mMinInput) * mScaler;
+        position = (position > 0.0f) ? position : 0.0f;
+        position = (position < (synth_float_t) kNumEntries)
+                ? position
+                : (synth_float_t) kNumEntries;
+        int32_t index = (int32_t) position;
+        synth_float_t fraction = position - (synth_float_t) index;
+        synth_float_t baseValue = mTable[index];
+        return baseValue + (fraction * (mTable[index + 1] - baseValue));
+    }
+
+    void lookup(const synth_float_t *inputs, synth_float_t *outputs,
+                int32_t count) const {
+        const SimdFloat minInput = SimdFloat::broadcast(mMinInput);
+        const SimdFloat scaler = SimdFloat::broadcast(mScaler);
+        const SimdFloat zero = SimdFloat::broadcast(0.0f);
+        const SimdFloat last = SimdFloat::broadcast((synth_float_t) kNumEntries);
+        int32_t i = 0;
+        for (; i + SimdFloat::kWidth <= count; i += SimdFloat::kWidth) {
+            SimdFloat position = (SimdFloat::load(inputs + i) - minInput) * scaler;
+            position = position.max(zero).min(last);
+            SimdFloat::interpolate(mTable, position).store(outputs + i);
+        }
+        for (; i < count; i++) {
+            outputs[i] = lookup(inputs[i]);
+        }
+    }
+
+    constexpr synth_float_t getEntry(int32_t index) const {
+        return mTable[index];
+    }
 
 private:
-    int32_t mNumEntries;
-    synth_float_t *mTable;
+    synth_float_t mMinInput;
+    synth_float_t mScaler;
+    synth_float_t mTable[kNumEntries + kGuardPoints] = {};
 };
 
+/**
+ * Tables shared by all of the units. Only the ones that are used end up in
+ * the binary.
+ */
+class LookupTables {
+public:
+    // 2^x for x from 0.0 to 1.0
+    static constexpr LookupTable<64> kPowerOfTwo{
+            ConstexprMath::powerOfTwo, 0.0, 1.0};
+    // One cycle of a sine for a phase from 0.0 to 1.0
+    static constexpr LookupTable<512> kSine{
+            ConstexprMath::sineCycle, 0.0, 1.0};
+    // tanh(x) for x from -5.0 to +5.0, a soft clipping curve
+    static constexpr LookupTable<512> kTanh{ConstexprMath::tanh, -5.0, 5.0};
+    // e^x for x from -8.0 to 0.0, an exponential decay curve
+    static constexpr LookupTable<512> kExp{ConstexprMath::exp, -8.0, 0.0};
+};
 
 #endif // SYNTHMARK_LOOKUP_TABLE_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_NOISE_GENERATOR_H
+#define SYNTHMARK_NOISE_GENERATOR_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "SynthRandom.h"
+#include "UnitGenerator.h"
+
+/**
+ * White noise from -1.0 to +1.0, or pink noise scaled to about the same
+ * peak level. Pink noise is not clamped, so rare peaks can go a little past
+ * 1.0.
+ *
+ * The random numbers come from a generator owned by the caller, eg. the
+ * voice, so the noise is reproducible and safe to render on any thread.
+ * Pink noise filters the white noise with Paul Kellet's three pole
+ * approximation of a -3 dB per octave slope, which is within 0.5 dB from
+ * 100 Hz up at 44.1 kHz.
+ */
+class NoiseGenerator : public UnitGenerator
+{
+public:
+    enum Color {
+        WHITE, PINK
+    };
+
+    NoiseGenerator() {}
+
+    virtual ~NoiseGenerator() = default;
+
+    void setColor(Color color) {
+        mColor = color;
+    }
+
+    Color getColor() const {
+        return mColor;
+    }
+
+    void generate(SynthRandom &random, int32_t numSamples) {
+        random.fillBipolar(output, numSamples);
+        if (mColor == PINK) {
+            filterPink(numSamples);
+        }
+        countOutput(numSamples);
+    }
+
+    /**
+     * Clear the pink filter, eg. when a voice restarts.
+     */
+    void reset() {
+        mPole0 = 0;
+        mPole1 = 0;
+        mPole2 = 0;
+    }
+
+private:
+    void filterPink(int32_t numSamples) {
+        // Keep the state in registers for the block.
+        synth_float_t pole0 = mPole0;
+        synth_float_t pole1 = mPole1;
+        synth_float_t pole2 = mPole2;
+        for (int32_t i = 0; i < numSamples; i++) {
+            const synth_float_t white = output[i];
+            pole0 = (0.99765f * pole0) + (0.0990460f * white);
+            pole1 = (0.96300f * pole1) + (0.2965164f * white);
+            pole2 = (0.57000f * pole2) + (1.0526913f * white);
+            output[i] = (pole0 + pole1 + pole2 + (0.1848f * white))
+                    * kPinkScaler;
+        }
+        mPole0 = DenormalGuard::flush(pole0);
+        mPole1 = DenormalGuard::flush(pole1);
+        mPole2 = DenormalGuard::flush(pole2);
+    }
+
+    // The filter adds a lot of low frequency gain. This brings the peaks of
+    // the pink noise back to about 1.0.
+    static constexpr synth_float_t kPinkScaler = 0.11f;
+
+    Color mColor = WHITE;
+    synth_float_t mPole0 = 0;
+    synth_float_t mPole1 = 0;
+    synth_float_t mPole2 = 0;
+};
+
+#endif // SYNTHMARK_NOISE_GENERATOR_H
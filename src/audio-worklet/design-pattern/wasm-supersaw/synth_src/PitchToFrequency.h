@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <math.h>
 #include "SynthMark.h"
+#include "FastMath.h"
 #include "LookupTable.h"
 #include "SynthTools.h"
 
@@ -32,20 +33,10 @@
 #define MIDDLE_C_PITCH  60
 #define MIDDLE_C_FREQUENCY  261.625549
 
-class PowerOfTwoTable : public LookupTable {
-public:
-    PowerOfTwoTable(int32_t numEntries)
-        : LookupTable(numEntries)
-        {
-            fillTable();
-        }
-
-    virtual ~PowerOfTwoTable() {}
-
-    virtual float calculate(float input) override {
-        return powf(2.0f, input);
-    }
-};
+// Range of the pitch table, in octaves either side of middle C.
+#define PITCH_TABLE_OCTAVES  8
+// Table entries per octave, enough for an error below 0.03 cents.
+#define PITCH_TABLE_RESOLUTION  64
 
 class PitchToFrequency
 {
@@ -57,47 +48,50 @@ public:
 
     static double convertPitchToFrequency(double pitch) {
         double exponent = (pitch - MIDDLE_C_PITCH) * (1.0 / SEMITONES_PER_OCTAVE);
-        return MIDDLE_C_FREQUENCY * pow(2.0, exponent);
+        return MIDDLE_C_FREQUENCY
+                * FastMath::exp2<FastMath::ACCURATE>((synth_float_t) exponent);
     }
 
-    synth_float_t lookupPitchToFrequency(synth_float_t pitch) {
-        // Only calculate if input changed since last time.
-        if (pitch != lastInput) {
-            synth_float_t octavePitch = (pitch - MIDDLE_C_PITCH) * (1.0 / SEMITONES_PER_OCTAVE);
-            int32_t octaveIndex = (int) floor(octavePitch);
-            synth_float_t fractionalOctave = octavePitch - octaveIndex;
-
-            // Do table lookup.
-            synth_float_t value = MIDDLE_C_FREQUENCY * mPowerTable.lookup(fractionalOctave);
-
-            // Adjust for octave by multiplying by a power of 2. Allow for +/- 16 octaves;
-            const int32_t octaveOffset = 16;
-            synth_float_t octaveScaler = ((synth_float_t)(1 << (octaveIndex + octaveOffset)))
-                * (1.0 / (1 << octaveOffset));
-            value *= octaveScaler;
+    /**
+     * Same as convertPitchToFrequency() but the compiler can evaluate it.
+     */
+    static constexpr double calculatePitchToFrequency(double pitch) {
+        double exponent = (pitch - MIDDLE_C_PITCH) * (1.0 / SEMITONES_PER_OCTAVE);
+        return MIDDLE_C_FREQUENCY * ConstexprMath::exp2(exponent);
+    }
 
-            lastInput = pitch;
-            lastOutput = value;
-            //printf("pitch = %f, index = %d, frequency = %f\n", pitch, index, value);
-        }
-        return lastOutput;
+    /**
+     * Pitches beyond PITCH_TABLE_OCTAVES from middle C are clamped.
+     */
+    static synth_float_t lookupPitchToFrequency(synth_float_t pitch) {
+        return getPitchTable().lookup(pitch);
     }
 
     /**
+     * Convert a block of pitches, for example for audio rate pitch
+     * modulation. This uses SIMD and does not branch per sample.
+     *
      * @param pitches an array of fractional MIDI pitches
      */
-    void generate(const synth_float_t *pitches, synth_float_t *frequencies, int32_t count) {
-        for (int i = 0; i < count; i++) {
-            frequencies[i] = lookupPitchToFrequency(pitches[i]);
-        }
+    static void generate(const synth_float_t *pitches, synth_float_t *frequencies,
+                         int32_t count) {
+        getPitchTable().lookup(pitches, frequencies, count);
     }
 
 private:
-    static PowerOfTwoTable mPowerTable;
-
-    synth_float_t lastInput = MIDDLE_C_PITCH;
-    synth_float_t lastOutput = MIDDLE_C_FREQUENCY;
-
+    static constexpr int32_t kPitchTableSize =
+            2 * PITCH_TABLE_OCTAVES * PITCH_TABLE_RESOLUTION;
+
+    // Frequencies of the pitches within PITCH_TABLE_OCTAVES of middle C,
+    // built by the compiler. It lives in a function because the class must
+    // be complete before calculatePitchToFrequency() can be evaluated.
+    static const LookupTable<kPitchTableSize> &getPitchTable() {
+        static constexpr LookupTable<kPitchTableSize> sPitchTable{
+                calculatePitchToFrequency,
+                MIDDLE_C_PITCH - (PITCH_TABLE_OCTAVES * SEMITONES_PER_OCTAVE),
+                MIDDLE_C_PITCH + (PITCH_TABLE_OCTAVES * SEMITONES_PER_OCTAVE)};
+        return sPitchTable;
+    }
 };
 
 #endif // SYNTHMARK_PITCH_TO_FREQUENCY_H
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RealtimeAudit.h"
+
+#if SYNTHMARK_RT_AUDIT
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <new>
+
+// The interceptors below replace the libc symbols for the whole process.
+// Allocation is forwarded to glibc's internal entry points and the other
+// calls to the next definition found by the dynamic linker. The plain
+// operator new and delete end up in malloc and free. The aligned ones are
+// replaced as well, in case the C++ library does not call aligned_alloc.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+void __libc_free(void *pointer);
+}
+
+namespace {
+
+thread_local int32_t tRealtimeDepth = 0;
+// Set while reporting or while inside a forwarded call, so that whatever
+// libc does internally is not reported a second time.
+thread_local bool tSuppressed = false;
+std::atomic<int32_t> gViolationCount{0};
+
+typedef int (*VfprintfFunction)(FILE *, const char *, va_list);
+typedef int (*PutsFunction)(const char *);
+typedef int (*FputsFunction)(const char *, FILE *);
+typedef size_t (*FwriteFunction)(const void *, size_t, size_t, FILE *);
+typedef int (*PutcharFunction)(int);
+typedef int (*MutexFunction)(pthread_mutex_t *);
+
+VfprintfFunction gRealVfprintf = nullptr;
+PutsFunction gRealPuts = nullptr;
+FputsFunction gRealFputs = nullptr;
+FwriteFunction gRealFwrite = nullptr;
+PutcharFunction gRealPutchar = nullptr;
+MutexFunction gRealMutexLock = nullptr;
+MutexFunction gRealMutexTrylock = nullptr;
+
+class ScopedSuppress {
+public:
+    ScopedSuppress() : mWasSuppressed(tSuppressed) {
+        tSuppressed = true;
+    }
+
+    ~ScopedSuppress() {
+        tSuppressed = mWasSuppressed;
+    }
+
+private:
+    bool mWasSuppressed;
+};
+
+void reportViolation(const char *function) {
+    if (tRealtimeDepth == 0 || tSuppressed) {
+        return;
+    }
+    ScopedSuppress suppress;
+    gViolationCount++;
+    char message[128];
+    int length = snprintf(message, sizeof(message),
+            "REALTIME VIOLATION: %s() called from a real-time section\n",
+            function);
+    if (write(STDERR_FILENO, message, length) < 0) {
+        return;
+    }
+    void *frames[32];
+    int numFrames = backtrace(frames, 32);
+    // Skip this function and the interceptor.
+    backtrace_symbols_fd(frames + 2, numFrames - 2, STDERR_FILENO);
+}
+
+void checkViolationsAtExit() {
+    int32_t count = gViolationCount.load();
+    if (count > 0) {
+        char message[96];
+        int length = snprintf(message, sizeof(message),
+                "REALTIME AUDIT: %d violation(s)\n", count);
+        if (write(STDERR_FILENO, message, length) < 0) {
+            // Nothing else to do, the exit code still reports the failure.
+        }
+        _exit(1);
+    }
+}
+
+template <typename Function>
+void resolve(Function *function, const char *name) {
+    *function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+// Resolve everything up front because dlsym() and the first backtrace()
+// may allocate.
+__attribute__((constructor)) void initializeAudit() {
+    ScopedSuppress suppress;
+    resolve(&gRealVfprintf, "vfprintf");
+    resolve(&gRealPuts, "puts");
+    resolve(&gRealFputs, "fputs");
+    resolve(&gRealFwrite, "fwrite");
+    resolve(&gRealPutchar, "putchar");
+    resolve(&gRealMutexLock, "pthread_mutex_lock");
+    resolve(&gRealMutexTrylock, "pthread_mutex_trylock");
+    void *frames[1];
+    backtrace(frames, 1);
+    atexit(checkViolationsAtExit);
+}
+
+} // namespace
+
+void RealtimeAudit::enterRealtime() {
+    tRealtimeDepth++;
+}
+
+void RealtimeAudit::exitRealtime() {
+    tRealtimeDepth--;
+}
+
+int32_t RealtimeAudit::getViolationCount() {
+    return gViolationCount.load();
+}
+
+void RealtimeAudit::resetViolationCount() {
+    gViolationCount.store(0);
+}
+
+extern "C" {
+
+void *malloc(size_t size) {
+    reportViolation("malloc");
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    reportViolation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    reportViolation("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    reportViolation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size) {
+    reportViolation("posix_memalign");
+    if (alignment % sizeof(void *) != 0
+            || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    void *memory = __libc_memalign(alignment, size);
+    if (memory == nullptr) {
+        return ENOMEM;
+    }
+    *pointer = memory;
+    return 0;
+}
+
+void *memalign(size_t alignment, size_t size) {
+    reportViolation("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void *valloc(size_t size) {
+    reportViolation("valloc");
+    return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size) {
+    reportViolation("pvalloc");
+    return __libc_pvalloc(size);
+}
+
+void free(void *pointer) {
+    if (pointer != nullptr) {
+        reportViolation("free");
+    }
+    __libc_free(pointer);
+}
+
+int vfprintf(FILE *stream, const char *format, va_list args) {
+    reportViolation("vfprintf");
+    ScopedSuppress suppress;
+    return gRealVfprintf(stream, format, args);
+}
+
+int vprintf(const char *format, va_list args) {
+    reportViolation("vprintf");
+    ScopedSuppress suppress;
+    return gRealVfprintf(stdout, format, args);
+}
+
+int fprintf(FILE *stream, const char *format, ...) {
+    reportViolation("fprintf");
+    ScopedSuppress suppress;
+    va_list args;
+    va_start(args, format);
+    int result = gRealVfprintf(stream, format, args);
+    va_end(args);
+    return result;
+}
+
+int printf(const char *format, ...) {
+    reportViolation("printf");
+    ScopedSuppress suppress;
+    va_list args;
+    va_start(args, format);
+    int result = gRealVfprintf(stdout, format, args);
+    va_end(args);
+    return result;
+}
+
+int puts(const char *text) {
+    reportViolation("puts");
+    ScopedSuppress suppress;
+    return gRealPuts(text);
+}
+
+int fputs(const char *text, FILE *stream) {
+    reportViolation("fputs");
+    ScopedSuppress suppress;
+    return gRealFputs(text, stream);
+}
+
+size_t fwrite(const void *data, size_t size, size_t count, FILE *stream) {
+    reportViolation("fwrite");
+    ScopedSuppress suppress;
+    return gRealFwrite(data, size, count, stream);
+}
+
+int putchar(int character) {
+    reportViolation("putchar");
+    ScopedSuppress suppress;
+    return gRealPutchar(character);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+    reportViolation("pthread_mutex_lock");
+    return gRealMutexLock(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) {
+    reportViolation("pthread_mutex_trylock");
+    return gRealMutexTrylock(mutex);
+}
+
+} // extern "C"
+
+namespace {
+
+void *alignedNew(size_t size, std::align_val_t alignment, const char *name) {
+    reportViolation(name);
+    return __libc_memalign(static_cast<size_t>(alignment),
+                           size == 0 ? 1 : size);
+}
+
+void alignedDelete(void *pointer, const char *name) {
+    if (pointer != nullptr) {
+        reportViolation(name);
+    }
+    __libc_free(pointer);
+}
+
+} // namespace
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    void *memory = alignedNew(size, alignment, "operator new");
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    void *memory = alignedNew(size, alignment, "operator new[]");
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+    return alignedNew(size, alignment, "operator new");
+}
+
+void *operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+    return alignedNew(size, alignment, "operator new[]");
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    alignedDelete(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    alignedDelete(pointer, "operator delete[]");
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept {
+    alignedDelete(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept {
+    alignedDelete(pointer, "operator delete[]");
+}
+
+void operator delete(void *pointer, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+    alignedDelete(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+    alignedDelete(pointer, "operator delete[]");
+}
+
+#endif // SYNTHMARK_RT_AUDIT
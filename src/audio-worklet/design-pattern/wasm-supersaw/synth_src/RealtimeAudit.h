@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_REALTIME_AUDIT_H
+#define SYNTHMARK_REALTIME_AUDIT_H
+
+#include <cstdint>
+
+/**
+ * Debug mode that catches calls which are not real-time safe.
+ *
+ * Build natively on Linux with -DSYNTHMARK_RT_AUDIT=1 (see `make audit`).
+ * malloc/free and the aligned allocators, the aligned operator new and
+ * delete, stdio output and mutex locking are then intercepted. Each
+ * call made while a ScopedRealtimeSection is alive on the calling thread is
+ * reported on stderr with a stack trace, and the process exits with an
+ * error if any were reported.
+ *
+ * Without SYNTHMARK_RT_AUDIT everything here compiles to nothing.
+ */
+
+#ifndef SYNTHMARK_RT_AUDIT
+#define SYNTHMARK_RT_AUDIT 0
+#endif
+
+class RealtimeAudit
+{
+public:
+#if SYNTHMARK_RT_AUDIT
+    static void enterRealtime();
+    static void exitRealtime();
+    static int32_t getViolationCount();
+    static void resetViolationCount();
+#else
+    static void enterRealtime() {}
+    static void exitRealtime() {}
+    static int32_t getViolationCount() { return 0; }
+    static void resetViolationCount() {}
+#endif
+};
+
+/**
+ * Marks the current thread as running real-time code until destroyed.
+ * Sections may be nested.
+ */
+class ScopedRealtimeSection
+{
+public:
+    ScopedRealtimeSection() {
+        RealtimeAudit::enterRealtime();
+    }
+
+    ~ScopedRealtimeSection() {
+        RealtimeAudit::exitRealtime();
+    }
+
+    ScopedRealtimeSection(const ScopedRealtimeSection &) = delete;
+    ScopedRealtimeSection &operator=(const ScopedRealtimeSection &) = delete;
+};
+
+#endif // SYNTHMARK_REALTIME_AUDIT_H
@@ -25,6 +25,7 @@
 #include <math.h>
 #include "SynthMark.h"
 #include "UnitGenerator.h"
+#include "ControlBlock.h"
 #include "DifferentiatedParabola.h"
 
 /**
@@ -42,7 +43,7 @@ public:
 
     void generate(synth_float_t frequency, int32_t numSamples) {
         synth_float_t phase = mPhase;
-        synth_float_t phaseIncrement = 2.0 * frequency * mSamplePeriod;
+        synth_float_t phaseIncrement = 2.0 * frequency * getSamplePeriod();
         for (int i = 0; i < numSamples; i++) {
             output[i] = translatePhase(phase, phaseIncrement);
             phase += phaseIncrement;
@@ -53,10 +54,11 @@ public:
         mPhase = phase;
     }
 
-    void generate(synth_float_t *frequencies, int32_t numSamples) {
+    void generate(const synth_float_t *frequencies, int32_t numSamples) {
         synth_float_t phase = mPhase;
+        const synth_float_t samplePeriod = getSamplePeriod();
         for (int i = 0; i < numSamples; i++) {
-            synth_float_t phaseIncrement = 2.0 * frequencies[i] * mSamplePeriod;
+            synth_float_t phaseIncrement = 2.0 * frequencies[i] * samplePeriod;
             output[i] = translatePhase(phase, phaseIncrement);
             phase += phaseIncrement;
             if (phase > 1.0) {
@@ -66,6 +68,18 @@ public:
         mPhase = phase;
     }
 
+    /**
+     * Use the cheaper fixed frequency loop when the frequency is CONSTANT.
+     */
+    void generate(const ControlBlock &frequency, int32_t numSamples) {
+        if (frequency.isConstant()) {
+            generate(frequency.value, numSamples);
+        } else {
+            synth_float_t buffer[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+            generate(frequency.render(buffer, numSamples), numSamples);
+        }
+    }
+
     virtual synth_float_t translatePhase(synth_float_t phase, synth_float_t phaseIncrement) {
         (void) phaseIncrement;
         return phase;
@@ -41,7 +41,8 @@ public:
     virtual ~SawtoothOscillatorDPW() = default;
 
     virtual inline synth_float_t translatePhase(synth_float_t phase, synth_float_t phaseIncrement) {
-        return dpw.next(phase, phaseIncrement);
+        return dpw.next(phase, phaseIncrement,
+                        mContext->getDpwVeryLowIncrement());
     }
 
 private:
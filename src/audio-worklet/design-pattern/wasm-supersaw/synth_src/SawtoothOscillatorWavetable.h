@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SAWTOOTH_OSCILLATOR_WAVETABLE_H
+#define SYNTHMARK_SAWTOOTH_OSCILLATOR_WAVETABLE_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "UnitGenerator.h"
+#include "ControlBlock.h"
+#include "SawtoothWavetable.h"
+
+/**
+ * Band limited sawtooth oscillator that reads from SawtoothWavetable.
+ * Suitable as a sound source, and a drop-in replacement for
+ * SawtoothOscillatorDPW.
+ *
+ * Unlike DPW there is no division per sample and no fallback to an aliasing
+ * raw sawtooth at very low frequencies.
+ */
+class SawtoothOscillatorWavetable : public UnitGenerator
+{
+public:
+    SawtoothOscillatorWavetable()
+    : mWavetable(&SawtoothWavetable::getInstance())
+    , mPhase(0) {}
+
+    virtual ~SawtoothOscillatorWavetable() = default;
+
+    void generate(synth_float_t frequency, int32_t numSamples) {
+        synth_float_t phase = mPhase;
+        synth_float_t phaseIncrement = 2.0 * frequency * getSamplePeriod();
+        // The frequency is fixed for the block, so is the level.
+        const SawtoothWavetable::Level &level = mWavetable->getLevel(
+                SawtoothWavetable::selectLevel(phaseIncrement));
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = SawtoothWavetable::lookup(level, phase);
+            phase += phaseIncrement;
+            if (phase > 1.0) {
+                phase -= 2.0;
+            }
+        }
+        mPhase = phase;
+    }
+
+    void generate(const synth_float_t *frequencies, int32_t numSamples) {
+        synth_float_t phase = mPhase;
+        const synth_float_t samplePeriod = getSamplePeriod();
+        for (int i = 0; i < numSamples; i++) {
+            synth_float_t phaseIncrement = 2.0 * frequencies[i] * samplePeriod;
+            const SawtoothWavetable::Level &level = mWavetable->getLevel(
+                    SawtoothWavetable::selectLevel(phaseIncrement));
+            output[i] = SawtoothWavetable::lookup(level, phase);
+            phase += phaseIncrement;
+            if (phase > 1.0) {
+                phase -= 2.0;
+            }
+        }
+        mPhase = phase;
+    }
+
+    /**
+     * Use the cheaper fixed frequency loop when the frequency is CONSTANT.
+     */
+    void generate(const ControlBlock &frequency, int32_t numSamples) {
+        if (frequency.isConstant()) {
+            generate(frequency.value, numSamples);
+        } else {
+            synth_float_t buffer[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+            generate(frequency.render(buffer, numSamples), numSamples);
+        }
+    }
+
+    void setPhase(synth_float_t phase) {
+        mPhase = phase;
+    }
+
+private:
+    const SawtoothWavetable *mWavetable;
+    synth_float_t mPhase; // between -1.0 and +1.0
+};
+
+#endif // SYNTHMARK_SAWTOOTH_OSCILLATOR_WAVETABLE_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SAWTOOTH_WAVETABLE_H
+#define SYNTHMARK_SAWTOOTH_WAVETABLE_H
+
+#include <cstdint>
+#include <math.h>
+#include <vector>
+#include "SynthMark.h"
+
+/**
+ * Band limited sawtooth tables, one per octave, shared read-only by every
+ * oscillator that uses them.
+ *
+ * Level k holds the first (kMaxHarmonics >> k) harmonics of a sawtooth that
+ * rises from -1.0 to +1.0 over one cycle. selectLevel() picks the level with
+ * the most harmonics that all stay below Nyquist, so the output never
+ * aliases, at the cost of up to an octave of missing top end.
+ *
+ * Like a mipmap, the tables get shorter as the harmonics get fewer. Each
+ * table has at least 32 samples per cycle of its top harmonic, which keeps
+ * the linear interpolation error small, and the short tables used by high
+ * notes stay in cache.
+ */
+class SawtoothWavetable
+{
+public:
+    static constexpr int32_t kNumLevels = 10;
+    static constexpr int32_t kMaxHarmonics = 1 << (kNumLevels - 1);
+    static constexpr int32_t kSamplesPerHarmonic = 32;
+    static constexpr int32_t kMinTableSize = 256;
+    // Two guard points after each table for interpolation and roundoff.
+    static constexpr int32_t kGuardPoints = 2;
+
+    struct Level {
+        const synth_float_t *table;
+        int32_t size;
+        // Converts a phase between -1.0 and +1.0 to a table position.
+        synth_float_t phaseScaler;
+        int32_t numHarmonics;
+    };
+
+    /**
+     * The tables are built on the first call, which allocates, so call this
+     * before rendering, for example from a constructor.
+     */
+    static const SawtoothWavetable &getInstance() {
+        static const SawtoothWavetable sWavetable;
+        return sWavetable;
+    }
+
+    static int32_t getNumHarmonics(int32_t level) {
+        return kMaxHarmonics >> level;
+    }
+
+    static int32_t getTableSize(int32_t level) {
+        int32_t size = getNumHarmonics(level) * kSamplesPerHarmonic;
+        return (size < kMinTableSize) ? kMinTableSize : size;
+    }
+
+    /**
+     * @param phaseIncrement phase change per sample, 2 * frequency / sampleRate
+     * @return index of the brightest level that does not alias
+     */
+    static int32_t selectLevel(synth_float_t phaseIncrement) {
+        if (phaseIncrement < 0.0f) {
+            phaseIncrement = 0.0f - phaseIncrement;
+        }
+        // Harmonic h is at h * phaseIncrement / 2 cycles per sample, so the
+        // level needs numHarmonics * phaseIncrement <= 1.
+        int32_t exponent;
+        double mantissa = frexp(kMaxHarmonics * (double) phaseIncrement, &exponent);
+        if (mantissa == 0.0 || exponent <= 0) {
+            return 0;
+        }
+        // Exact powers of two, mantissa 0.5, fit the level below.
+        int32_t level = (mantissa == 0.5) ? exponent - 1 : exponent;
+        return (level >= kNumLevels) ? kNumLevels - 1 : level;
+    }
+
+    const Level &getLevel(int32_t level) const {
+        return mLevels[level];
+    }
+
+    /**
+     * Interpolated value at a phase between -1.0 and +1.0.
+     */
+    static inline synth_float_t lookup(const Level &level, synth_float_t phase) {
+        synth_float_t position = (phase + 1.0f) * level.phaseScaler;
+        int32_t index = (int32_t) position;
+        synth_float_t fraction = position - index;
+        synth_float_t baseValue = level.table[index];
+        return baseValue + (fraction * (level.table[index + 1] - baseValue));
+    }
+
+private:
+    SawtoothWavetable() {
+        int32_t totalSize = 0;
+        for (int32_t level = 0; level < kNumLevels; level++) {
+            totalSize += getTableSize(level) + kGuardPoints;
+        }
+        mStorage.resize(totalSize);
+
+        // Every table size divides the largest one, so the partial sums of
+        // all levels can be taken on the grid of level 0. sin(2 pi h m / N)
+        // is read from one cycle of a sine on that grid.
+        const int32_t gridSize = getTableSize(0);
+        std::vector<double> sine(gridSize);
+        for (int32_t m = 0; m < gridSize; m++) {
+            sine[m] = sin(2.0 * M_PI * m / gridSize);
+        }
+        std::vector<double> sum(gridSize, 0.0);
+        synth_float_t *table = mStorage.data() + totalSize;
+        for (int32_t harmonic = 1; harmonic <= kMaxHarmonics; harmonic++) {
+            const double amplitude = 1.0 / harmonic;
+            for (int32_t m = 0; m < gridSize; m++) {
+                sum[m] += amplitude * sine[(harmonic * m) & (gridSize - 1)];
+            }
+            // Snapshot the level that ends at this harmonic. Levels with
+            // fewer harmonics are stored at the end of mStorage.
+            int32_t level = kNumLevels - 1;
+            while (level >= 0 && getNumHarmonics(level) < harmonic) {
+                level--;
+            }
+            if (level < 0 || getNumHarmonics(level) != harmonic) {
+                continue;
+            }
+            const int32_t size = getTableSize(level);
+            const int32_t stride = gridSize / size;
+            table -= size + kGuardPoints;
+            // A rising sawtooth is -(2 / pi) * sum(sin(h * theta) / h).
+            for (int32_t n = 0; n < size; n++) {
+                table[n] = (synth_float_t) (-(2.0 / M_PI) * sum[n * stride]);
+            }
+            for (int32_t n = 0; n < kGuardPoints; n++) {
+                table[size + n] = table[n];
+            }
+            mLevels[level].table = table;
+            mLevels[level].size = size;
+            mLevels[level].phaseScaler = 0.5f * size;
+            mLevels[level].numHarmonics = harmonic;
+        }
+    }
+
+    std::vector<synth_float_t> mStorage;
+    Level mLevels[kNumLevels];
+};
+
+#endif // SYNTHMARK_SAWTOOTH_WAVETABLE_H
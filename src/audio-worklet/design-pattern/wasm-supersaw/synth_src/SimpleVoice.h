@@ -21,23 +21,39 @@
 #include "SynthMark.h"
 #include "SynthTools.h"
 #include "VoiceBase.h"
-#include "SawtoothOscillator.h"
-#include "SawtoothOscillatorDPW.h"
-#include "SquareOscillatorDPW.h"
-#include "BiquadFilter.h"
+#include "SupersawOscillatorBank.h"
+#include "BiquadCascade.h"
 #include "EnvelopeADSR.h"
 #include "PitchToFrequency.h"
+#include "SmoothedParameter.h"
+#include "NoiseGenerator.h"
+#include "SynthRandom.h"
 
+// Time in seconds to fade out a stolen voice before it plays its new note.
+#define SIMPLE_VOICE_STEAL_FADE_TIME  0.002
+// Time constant in seconds for smoothing filter cutoff changes.
+#define SIMPLE_VOICE_SMOOTHING_TIME  0.005
 
-class SimpleVoice : public VoiceBase {
+class SimpleVoice final : public VoiceBase {
  public:
+  // Generators whose output can be counted, see setSampleCounting().
+  enum Stage {
+    kOscillators,
+    kNoise,
+    kFilter,
+    kFilterEnvelope,
+    kAmpEnvelope,
+    kVoiceOutput,
+    kNumStages
+  };
+
   SimpleVoice()
       : VoiceBase(),
-        mFilter1(),
-        mFilter2(),
+        mSupersaw(),
+        mFilter(),
         mFilterEnv(),
         mAmpEnv() {
-    mSawOscs = new SawtoothOscillatorDPW[mNumOscs];
+    mSupersaw.setUnison(mUnisonCount, mUnisonSpread);
     mFilterEnv.setAttackTime(0.02);
     mFilterEnv.setDecayTime(0.02);
     mFilterEnv.setSustainLevel(0.707);
@@ -46,43 +62,91 @@ class SimpleVoice : public VoiceBase {
     mAmpEnv.setDecayTime(0.02);
     mAmpEnv.setSustainLevel(0.707);
     mAmpEnv.setReleaseTime(0.05);
+    setGlideFactor(mGlideFactor);
+    updateSmoothing();
   }
 
-  ~SimpleVoice() {
-    delete[] mSawOscs;
-  };
+  ~SimpleVoice() = default;
 
-  void generate(int32_t numFrames) {
-    synth_float_t *frequencyBuffer = mBuffer1;
-    synth_float_t *mixBuffer = mBuffer2;
-    memset(mixBuffer, 0, numFrames * sizeof(float));
-    computeFrequency();
-    for (int osc = 0; osc < mNumOscs; ++osc) {
-      SynthTools::fillBuffer(
-          frequencyBuffer, numFrames, mFrequency * mDetune[osc]);
-      mSawOscs[osc].generate(frequencyBuffer, numFrames);
-      SynthTools::addBuffers(
-          mSawOscs[osc].output, mOscGains[osc], mixBuffer, numFrames);
+  void generate(int32_t numFrames) override {
+    static thread_local VoiceScratch scratch;
+    generate(numFrames, &scratch);
+  }
+
+  // The scratch buffers may be shared with other voices rendered on the
+  // same thread.
+  void generate(int32_t numFrames, VoiceScratch* scratch) {
+    // Each control is CONSTANT, RAMP or AUDIO for the block, see
+    // ControlBlock, and the generators skip the work that does not apply.
+    mSupersaw.generate(mFrequency.next(numFrames), numFrames);
+    synth_float_t *mixBuffer = mSupersaw.output;
+    if (mNoiseLevel > 0) {
+      mNoise.generate(mRandom, numFrames);
+      SynthTools::addBuffers(mNoise.output, mNoiseLevel, mixBuffer, numFrames);
     }
 
     mFilterEnv.generate(numFrames);
-    synth_float_t *cutoffBuffer = mBuffer1;
-    SynthTools::scaleOffsetBuffer(mFilterEnv.output, cutoffBuffer, numFrames,
-                                  mFilterEnvDepth, mFilterCutoff);
-    mFilter1.generate(mixBuffer, cutoffBuffer, numFrames);
-    mFilter2.generate(mFilter1.output, cutoffBuffer, numFrames);
+    ControlBlock cutoff = mFilterCutoff.next(numFrames).addScaled(
+        mFilterEnv.getOutput(), mFilterEnvDepth, scratch->buffer1, numFrames);
+    mFilter.generate(mixBuffer, cutoff, numFrames);
 
     mAmpEnv.generate(numFrames);
+    ControlBlock amplitude = mAmpEnv.getOutput();
+    if (amplitude.isConstant()) {
+      SynthTools::scaleBuffer(
+          mFilter.output, UnitGenerator::output, numFrames, amplitude.value);
+    } else {
+      SynthTools::multiplyBuffers(
+          mFilter.output, amplitude.samples, UnitGenerator::output, numFrames);
+    }
+
+    if (mStealing)
+      applyStealFade(numFrames);
+    countOutput(numFrames);
+  }
+
+  void setEngineContext(EngineContext* context) override {
+    VoiceBase::setEngineContext(context);
+    mSupersaw.setEngineContext(context);
+    mNoise.setEngineContext(context);
+    mFilter.setEngineContext(context);
+    mFilterEnv.setEngineContext(context);
+    mAmpEnv.setEngineContext(context);
+    updateSmoothing();
+  }
+
+  /**
+   * Restart the voice's random sequence, which sets the oscillator phases of
+   * each note and the noise. The same seed and notes give the same output.
+   */
+  void setRandomSeed(uint64_t seed) {
+    mRandom.setSeed(seed);
+  }
 
-    SynthTools::multiplyBuffers(
-        mFilter2.output, mAmpEnv.output, UnitGenerator::output, numFrames);
+  /**
+   * Count denormal, NaN and infinite samples in the output of every stage
+   * from now on, see SampleCounters. Each counted stage reads its output
+   * once more, so this is off by default.
+   */
+  void setSampleCounting(bool enabled) {
+    auto counters = [=](Stage stage) {
+      return enabled ? &mSampleCounters[stage] : nullptr;
+    };
+    mSupersaw.setSampleCounters(counters(kOscillators));
+    mNoise.setSampleCounters(counters(kNoise));
+    mFilter.setSampleCounters(counters(kFilter));
+    mFilterEnv.setSampleCounters(counters(kFilterEnvelope));
+    mAmpEnv.setSampleCounters(counters(kAmpEnvelope));
+    setSampleCounters(counters(kVoiceOutput));
+  }
+
+  const SampleCounters& getSampleCounters(Stage stage) const {
+    return mSampleCounters[stage];
   }
 
   void start() {
-    for (int osc = 0; osc < mNumOscs; ++osc)
-      mSawOscs[osc].setPhase(SynthTools::nextRandomDouble());
-    mFilterEnv.setGate(true);
-    mAmpEnv.setGate(true);
+    mSupersaw.randomizePhases(mRandom);
+    openGates();
   }
 
   void stop() {
@@ -90,22 +154,92 @@ class SimpleVoice : public VoiceBase {
     mAmpEnv.setGate(false);
   }
 
+  /**
+   * Fade out the current note quickly and then start the given pitch,
+   * gliding from glideFromPitch, see glideFrom().
+   */
+  void steal(synth_float_t pitch, synth_float_t glideFromPitch) {
+    mStealPitch = pitch;
+    mStealGlideFromPitch = glideFromPitch;
+    mStealGain = 1.0;
+    mStealing = true;
+  }
+
+  /**
+   * An inactive voice is silent until start() is called. Synthesizer stops
+   * rendering a voice as soon as it is inactive, see
+   * VoiceAllocator::release().
+   */
+  bool isActive() {
+    return mStealing || mAmpEnv.isActive();
+  }
+
+  bool isReleased() {
+    return !mStealing && !mAmpEnv.isGateOn();
+  }
+
+  synth_float_t getAmplitude() {
+    return mAmpEnv.getLevel();
+  }
+
+  /**
+   * Use DPW or wavetable sawtooths, see SupersawOscillatorBank::setSource().
+   */
+  void setOscillatorSource(SupersawOscillatorBank::Source source) {
+    mSupersaw.setSource(source);
+  }
+
+  /**
+   * Play count detuned sawtooths, see SupersawOscillatorBank::setUnison().
+   * The render cost grows with the count.
+   */
+  void setUnison(int32_t count, synth_float_t spread) {
+    mUnisonCount = count;
+    mUnisonSpread = spread;
+    mSupersaw.setUnison(count, spread);
+  }
+
+  /**
+   * Mix noise into the oscillators before the filter. A level of 0.0 turns
+   * the noise generator off.
+   */
+  void setNoise(synth_float_t level, NoiseGenerator::Color color) {
+    mNoiseLevel = level;
+    mNoise.setColor(color);
+  }
+
   void setPitch(synth_float_t pitch) {
-    mTargetFrequency = PitchToFrequency::convertPitchToFrequency(pitch);
+    mFrequency.setTarget(PitchToFrequency::convertPitchToFrequency(pitch));
+  }
+
+  /**
+   * Move the sounding pitch to the given one and glide from there to the
+   * pitch set with setPitch(), for portamento between notes. Call it after
+   * start(), which otherwise starts a silent voice at its pitch.
+   */
+  void glideFrom(synth_float_t pitch) {
+    synth_float_t target = mFrequency.getTarget();
+    mFrequency.jump(PitchToFrequency::convertPitchToFrequency(pitch));
+    mFrequency.setTarget(target);
   }
 
   void setGlideFactor(synth_float_t glideFactor) {
     mGlideFactor = glideFactor;
+    // The factor is the fraction of the way to the new pitch covered every
+    // SYNTHMARK_FRAMES_PER_RENDER frames. Apply it per sample so the glide
+    // does not depend on the block size.
+    synth_float_t retention = (glideFactor >= 1.0) ? 0.0
+        : pow(1.0 - glideFactor, 1.0 / SYNTHMARK_FRAMES_PER_RENDER);
+    mFrequency.setRetention(retention);
   }
 
   void setFilterCutoff(synth_float_t filterCutoff) {
-    mFilterCutoff = filterCutoff;
+    mFilterCutoff.setTarget(filterCutoff);
   }
 
   void setFilterQ(synth_float_t filterQ) {
     mFilterQ = filterQ;
-    mFilter1.setQ(mFilterQ);
-    mFilter2.setQ(mFilterQ);
+    mFilter.setQ(mFilterQ);
   }
 
   void setFilterEnvDepth(synth_float_t envDepth) {
@@ -144,44 +278,129 @@ class SimpleVoice : public VoiceBase {
     mAmpEnv.setReleaseTime(releaseTime);
   }
 
-  void printParameters() {
+  // Copy of the patch settings that can be handed to another thread.
+  struct Parameters {
+    int32_t unisonCount;
+    synth_float_t unisonSpread;
+    synth_float_t noiseLevel;
+    NoiseGenerator::Color noiseColor;
+    synth_float_t glideFactor;
+    synth_float_t filterCutoff;
+    synth_float_t filterQ;
+    synth_float_t filterEnvDepth;
+    synth_float_t filterAttack;
+    synth_float_t filterDecay;
+    synth_float_t filterSustain;
+    synth_float_t filterRelease;
+    synth_float_t ampAttack;
+    synth_float_t ampDecay;
+    synth_float_t ampSustain;
+    synth_float_t ampRelease;
+  };
+
+  Parameters getParameters() {
+    Parameters parameters;
+    parameters.unisonCount = mUnisonCount;
+    parameters.unisonSpread = mUnisonSpread;
+    parameters.noiseLevel = mNoiseLevel;
+    parameters.noiseColor = mNoise.getColor();
+    parameters.glideFactor = mGlideFactor;
+    parameters.filterCutoff = mFilterCutoff.getTarget();
+    parameters.filterQ = mFilterQ;
+    parameters.filterEnvDepth = mFilterEnvDepth;
+    parameters.filterAttack = mFilterEnv.getAttackTime();
+    parameters.filterDecay = mFilterEnv.getDecayTime();
+    parameters.filterSustain = mFilterEnv.getSustainLevel();
+    parameters.filterRelease = mFilterEnv.getReleaseTime();
+    parameters.ampAttack = mAmpEnv.getAttackTime();
+    parameters.ampDecay = mAmpEnv.getDecayTime();
+    parameters.ampSustain = mAmpEnv.getSustainLevel();
+    parameters.ampRelease = mAmpEnv.getReleaseTime();
+    return parameters;
+  }
+
+  // Not real-time safe, see Synthesizer::printStatus().
+  static void printParameters(const Parameters& parameters) {
     printf(
         "------------------\n"
+        "UNISON:\n Count=%d\n Spread=%f\n"
+        "NOISE:\n Level=%f\n Color=%s\n"
         "TONE:\n Glide=%f\n Cutoff=%f\n Q=%f\n FilterEnvDepth=%f\n"
         "FILTER ENV:\n A=%f\n D=%f\n S=%f\n R=%f\n"
         "AMP ENV:\n A=%f\n D=%f\n S=%f\n R=%f\n",
-        mGlideFactor, mFilterCutoff, mFilterQ, mFilterEnvDepth,
-        mFilterEnv.getAttackTime(), mFilterEnv.getDecayTime(),
-        mFilterEnv.getSustainLevel(), mFilterEnv.getReleaseTime(),
-        mAmpEnv.getAttackTime(), mAmpEnv.getDecayTime(),
-        mAmpEnv.getSustainLevel(), mAmpEnv.getReleaseTime());
+        parameters.unisonCount, parameters.unisonSpread,
+        parameters.noiseLevel,
+        parameters.noiseColor == NoiseGenerator::PINK ? "pink" : "white",
+        parameters.glideFactor, parameters.filterCutoff, parameters.filterQ,
+        parameters.filterEnvDepth, parameters.filterAttack,
+        parameters.filterDecay, parameters.filterSustain,
+        parameters.filterRelease, parameters.ampAttack, parameters.ampDecay,
+        parameters.ampSustain, parameters.ampRelease);
   }
 
  private:
-  void computeFrequency() {
-    mFrequency += (mTargetFrequency - mFrequency) * mGlideFactor;
+  void updateSmoothing() {
+    mFilterCutoff.setRetention(
+        exp(-1.0 / (SIMPLE_VOICE_SMOOTHING_TIME * getSampleRate())));
+  }
+
+  void applyStealFade(int32_t numFrames) {
+    const synth_float_t decrement =
+        getSamplePeriod() / SIMPLE_VOICE_STEAL_FADE_TIME;
+    for (int i = 0; i < numFrames; i++) {
+      output[i] *= mStealGain;
+      if (mStealGain > decrement)
+        mStealGain -= decrement;
+      else
+        mStealGain = 0;
+    }
+    if (mStealGain == 0) {
+      mStealing = false;
+      mFilterEnv.reset();
+      mAmpEnv.reset();
+      setPitch(mStealPitch);
+      mSupersaw.randomizePhases(mRandom);
+      openGates();
+      glideFrom(mStealGlideFromPitch);
+    }
   }
 
-  SawtoothOscillatorDPW* mSawOscs = nullptr;
-  BiquadFilter mFilter1;
-  BiquadFilter mFilter2;
+  void openGates() {
+    // A voice that was silent starts at its new pitch instead of gliding.
+    // The amp envelope comes after the filters, so any filter tail was
+    // multiplied by zero and is dropped rather than heard in the new note.
+    if (!mAmpEnv.isActive()) {
+      mFrequency.jump(mFrequency.getTarget());
+      mFilter.reset();
+    }
+    mFilterEnv.setGate(true);
+    mAmpEnv.setGate(true);
+  }
+
+  // Owned by the voice so that voices on different threads never share it.
+  SynthRandom mRandom;
+  SupersawOscillatorBank mSupersaw;
+  NoiseGenerator mNoise;
+  // Two lowpass stages with the same cutoff and Q.
+  BiquadCascade mFilter;
   EnvelopeADSR mFilterEnv;
   EnvelopeADSR mAmpEnv;
 
-  int32_t mNumOscs = 7;
-  synth_float_t mDetune[7] =
-      {0.8908, 0.9382, 0.9811, 1, 1.0204, 1.0633, 1.1077};
-  synth_float_t mOscGains[7] =
-      {0.0789, 0.1052, 0.1578, 0.3157, 0.1578, 0.1052, 0.07894};
-  synth_float_t mTargetFrequency = 261.63;
-  synth_float_t mFrequency = 261.63;
+  SampleCounters mSampleCounters[kNumStages];
+
+  int32_t mUnisonCount = 7;
+  synth_float_t mUnisonSpread = 1.0;
+  synth_float_t mNoiseLevel = 0;
+  SmoothedParameter mFrequency{261.63};
   synth_float_t mGlideFactor = 0.01;
-  synth_float_t mFilterCutoff = 8000;
+  SmoothedParameter mFilterCutoff{8000};
   synth_float_t mFilterQ = 0.01;
   synth_float_t mFilterEnvDepth = 100;
 
-  synth_float_t mBuffer1[SYNTHMARK_FRAMES_PER_RENDER];
-  synth_float_t mBuffer2[SYNTHMARK_FRAMES_PER_RENDER];
+  bool mStealing = false;
+  synth_float_t mStealGain = 1.0;
+  synth_float_t mStealPitch = 60.0;
+  synth_float_t mStealGlideFromPitch = 60.0;
 };
 
 #endif // SIMPLE_VOICE_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SMOOTHED_PARAMETER_H
+#define SYNTHMARK_SMOOTHED_PARAMETER_H
+
+#include <cstdint>
+#include <assert.h>
+#include <math.h>
+#include "SynthMark.h"
+#include "ControlBlock.h"
+
+/**
+ * A control value that glides exponentially towards its target instead of
+ * jumping, to avoid zipper noise.
+ *
+ * Every sample the remaining distance to the target is multiplied by the
+ * retention. next() lands exactly on that curve at the end of each block
+ * and ramps linearly in between, so the result does not depend on the block
+ * size. Once the value is within rounding of the target it snaps to it and
+ * next() returns CONSTANT blocks, which cost nothing downstream.
+ */
+class SmoothedParameter
+{
+public:
+    // Enough powers for blocks of up to 2^kNumPowers - 1 frames.
+    static constexpr int32_t kNumPowers = 8;
+
+    explicit SmoothedParameter(synth_float_t value = 0) {
+        jump(value);
+        setRetention(0);
+    }
+
+    /**
+     * @param retention fraction of the distance to the target that is left
+     *     after each sample, 0 to jump to the target immediately
+     */
+    void setRetention(synth_float_t retention) {
+        mRetention = retention;
+        // mPowers[k] = retention^(2^k)
+        double power = retention;
+        for (int32_t k = 0; k < kNumPowers; k++) {
+            mPowers[k] = (synth_float_t) power;
+            power *= power;
+        }
+    }
+
+    synth_float_t getRetention() const {
+        return mRetention;
+    }
+
+    void setTarget(synth_float_t target) {
+        mTarget = target;
+    }
+
+    synth_float_t getTarget() const {
+        return mTarget;
+    }
+
+    /**
+     * Set the value and the target without smoothing.
+     */
+    void jump(synth_float_t value) {
+        mValue = value;
+        mTarget = value;
+    }
+
+    synth_float_t getValue() const {
+        return mValue;
+    }
+
+    /**
+     * Advance by numFrames and describe the values of those frames.
+     */
+    ControlBlock next(int32_t numFrames) {
+        if (mValue == mTarget || mRetention == 0.0f) {
+            mValue = mTarget;
+            return ControlBlock::constant(mValue);
+        }
+        synth_float_t end = mTarget + ((mValue - mTarget) * power(numFrames));
+        synth_float_t distance = end - mTarget;
+        synth_float_t magnitude = (mTarget < 0.0f) ? 0.0f - mTarget : mTarget;
+        if (distance < 0.0f) {
+            distance = 0.0f - distance;
+        }
+        // Also snap if the step is lost in rounding, which can happen with
+        // short blocks before the snap distance is reached.
+        if (distance <= (magnitude * kSnapRatio) + kSnapDistance
+                || end == mValue) {
+            end = mTarget;
+        }
+        synth_float_t increment = (end - mValue) / numFrames;
+        ControlBlock block = ControlBlock::ramp(mValue + increment, increment);
+        mValue = end;
+        return block;
+    }
+
+private:
+    static constexpr synth_float_t kSnapRatio = 1.0e-5f;
+    static constexpr synth_float_t kSnapDistance = 1.0e-6f;
+
+    // retention^numFrames from the binary digits of numFrames
+    synth_float_t power(int32_t numFrames) const {
+        assert(numFrames > 0 && numFrames < (1 << kNumPowers));
+        synth_float_t result = 1.0f;
+        for (int32_t k = 0; numFrames != 0; k++, numFrames >>= 1) {
+            if (numFrames & 1) {
+                result *= mPowers[k];
+            }
+        }
+        return result;
+    }
+
+    synth_float_t mValue;
+    synth_float_t mTarget;
+    synth_float_t mRetention;
+    synth_float_t mPowers[kNumPowers];
+};
+
+#endif // SYNTHMARK_SMOOTHED_PARAMETER_H
@@ -43,13 +43,14 @@ public:
     virtual ~SquareOscillatorDPW() = default;
 
     virtual inline synth_float_t translatePhase(synth_float_t phase1, synth_float_t phaseIncrement) {
-        synth_float_t val1 = dpw1.next(phase1, phaseIncrement);
+        const synth_float_t veryLowIncrement = mContext->getDpwVeryLowIncrement();
+        synth_float_t val1 = dpw1.next(phase1, phaseIncrement, veryLowIncrement);
 
         /* Generate second sawtooth so we can add them together. */
         synth_float_t phase2 = phase1 + 1.0; /* 180 degrees out of phase. */
         if (phase2 >= 1.0)
             phase2 -= 2.0;
-        synth_float_t val2 = dpw1.next(phase2, phaseIncrement);
+        synth_float_t val2 = dpw1.next(phase2, phaseIncrement, veryLowIncrement);
 
         /*
          * Need to adjust amplitude based on positive phaseInc. little less than half at
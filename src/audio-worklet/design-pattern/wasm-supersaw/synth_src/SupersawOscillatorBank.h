@@ -0,0 +1,420 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SUPERSAW_OSCILLATOR_BANK_H
+#define SYNTHMARK_SUPERSAW_OSCILLATOR_BANK_H
+
+#include <cstdint>
+#include <assert.h>
+#include <math.h>
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "SynthTools.h"
+#include "UnitGenerator.h"
+#include "ControlBlock.h"
+#include "DifferentiatedParabola.h"
+#include "SawtoothWavetable.h"
+#include "SynthRandom.h"
+
+#define SUPERSAW_MAX_OSCILLATORS  16
+// Frequency ratio offset of the outermost oscillators at a spread of 1.0.
+#define SUPERSAW_MAX_DETUNE  0.11
+
+/**
+ * A set of detuned DPW sawtooth oscillators mixed to one output.
+ *
+ * This produces the same waveform as a SawtoothOscillatorDPW per detuned
+ * copy, but the phases and DPW delay lines are kept in structure-of-arrays
+ * form and every oscillator is advanced in its own SIMD lane. There is no
+ * virtual call per sample and the DPW scaling uses a reciprocal that is
+ * computed once per block instead of a division per sample.
+ *
+ * With setSource(WAVETABLE) the oscillators read from the band limited
+ * SawtoothWavetable instead, which does not alias at any pitch.
+ *
+ * Only the SIMD vectors that hold used oscillators are rendered, so the cost
+ * grows with the oscillator count rather than SUPERSAW_MAX_OSCILLATORS.
+ */
+class SupersawOscillatorBank : public UnitGenerator
+{
+public:
+    // Lanes are padded to a whole number of SIMD vectors.
+    static constexpr int32_t kNumVectors =
+            (SUPERSAW_MAX_OSCILLATORS + SimdFloat::kWidth - 1)
+            / SimdFloat::kWidth;
+    static constexpr int32_t kNumLanes = kNumVectors * SimdFloat::kWidth;
+
+    SupersawOscillatorBank() {
+        for (int32_t lane = 0; lane < kNumLanes; lane++) {
+            mPhase[lane] = 0;
+            mZ1[lane] = 0;
+            mZ2[lane] = 0;
+            mDetune[lane] = 0;
+            mGain[lane] = 0;
+        }
+    }
+
+    virtual ~SupersawOscillatorBank() = default;
+
+    enum Source {
+        DPW, WAVETABLE
+    };
+
+    /**
+     * Select how the sawtooth is generated. The first call with WAVETABLE
+     * builds the shared tables, so do not call it from the audio thread.
+     */
+    void setSource(Source source) {
+        if (source == WAVETABLE && mWavetable == nullptr) {
+            mWavetable = &SawtoothWavetable::getInstance();
+        }
+        if (source == DPW && mSource != DPW) {
+            // The DPW delay lines went stale while the tables were used.
+            mPrimeDelayLines = true;
+        }
+        mSource = source;
+    }
+
+    Source getSource() const {
+        return mSource;
+    }
+
+    /**
+     * @param detunes frequency ratio of each oscillator
+     * @param gains mix level of each oscillator
+     * @param count number of oscillators, at most SUPERSAW_MAX_OSCILLATORS
+     */
+    void setOscillators(const synth_float_t *detunes,
+                        const synth_float_t *gains,
+                        int32_t count) {
+        assert(count >= 0 && count <= SUPERSAW_MAX_OSCILLATORS);
+        for (int32_t lane = 0; lane < kNumLanes; lane++) {
+            // Unused lanes run at zero frequency with zero gain.
+            mDetune[lane] = (lane < count) ? detunes[lane] : 0;
+            mGain[lane] = (lane < count) ? gains[lane] : 0;
+        }
+        const int32_t numVectors =
+                (count + SimdFloat::kWidth - 1) / SimdFloat::kWidth;
+        if (mNumVectors > 0 && numVectors > mNumVectors) {
+            // Lanes that were skipped have stale DPW delay lines.
+            mPrimeDelayLines = true;
+        }
+        mNumOscillators = count;
+        mNumVectors = numVectors;
+    }
+
+    /**
+     * Spread count oscillators symmetrically around the note.
+     *
+     * Oscillator k sits at position p from -1.0 to +1.0 across the unison
+     * and is detuned by SUPERSAW_MAX_DETUNE * spread * p * sqrt(|p|), so the
+     * inner copies stay close to the note. Its gain is proportional to
+     * 1 / (1 + 3 * |p|) and the gains add up to 1.0, so the level does not
+     * depend on the count. Seven oscillators at a spread of 1.0 give the
+     * classic supersaw.
+     *
+     * @param count number of oscillators, 1 to SUPERSAW_MAX_OSCILLATORS
+     * @param spread amount of detune, 0.0 for none
+     */
+    void setUnison(int32_t count, synth_float_t spread) {
+        assert(count >= 1 && count <= SUPERSAW_MAX_OSCILLATORS);
+        synth_float_t detunes[SUPERSAW_MAX_OSCILLATORS];
+        synth_float_t gains[SUPERSAW_MAX_OSCILLATORS];
+        synth_float_t sum = 0;
+        for (int32_t k = 0; k < count; k++) {
+            double position = (count == 1) ? 0.0
+                    : ((2.0 * k) / (count - 1)) - 1.0;
+            double magnitude = fabs(position);
+            detunes[k] = (synth_float_t) (1.0 + (SUPERSAW_MAX_DETUNE * spread
+                    * position * sqrt(magnitude)));
+            gains[k] = (synth_float_t) (1.0 / (1.0 + (3.0 * magnitude)));
+            sum += gains[k];
+        }
+        for (int32_t k = 0; k < count; k++) {
+            gains[k] /= sum;
+        }
+        setOscillators(detunes, gains, count);
+    }
+
+    int32_t getNumOscillators() const {
+        return mNumOscillators;
+    }
+
+    synth_float_t getDetune(int32_t index) const {
+        return mDetune[index];
+    }
+
+    synth_float_t getGain(int32_t index) const {
+        return mGain[index];
+    }
+
+    /**
+     * Start every oscillator at a random phase between 0.0 and 1.0.
+     */
+    void randomizePhases(SynthRandom &random) {
+        random.fillUniform(mPhase, kNumLanes);
+        mPrimeDelayLines = true;
+    }
+
+    void generate(synth_float_t frequency, int32_t numSamples) {
+        generate(ControlBlock::constant(frequency), numSamples);
+    }
+
+    /**
+     * A CONSTANT frequency sets up the increments once for the block. A
+     * RAMP or AUDIO frequency updates them, and the DPW scaling, every
+     * sample, so glides are smooth.
+     */
+    void generate(const ControlBlock &frequency, int32_t numSamples) {
+        if (frequency.isConstant()) {
+            if (mSource == WAVETABLE) {
+                generateWavetable<false>(frequency.value, nullptr, numSamples);
+            } else {
+                generateDpw<false, kNumVectors>(frequency.value, nullptr,
+                                                numSamples);
+            }
+            countOutput(numSamples);
+            return;
+        }
+        alignas(32) synth_float_t buffer[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+        const synth_float_t *frequencies = frequency.render(buffer, numSamples);
+        // The lowest frequency decides between raw and DPW, the highest
+        // decides the table level.
+        synth_float_t lowest = 0.0f;
+        synth_float_t highest = 0.0f;
+        for (int32_t i = 0; i < numSamples; i++) {
+            synth_float_t magnitude = (frequencies[i] < 0.0f)
+                    ? 0.0f - frequencies[i]
+                    : frequencies[i];
+            if (i == 0 || magnitude < lowest) {
+                lowest = magnitude;
+            }
+            if (magnitude > highest) {
+                highest = magnitude;
+            }
+        }
+        if (mSource == WAVETABLE) {
+            generateWavetable<true>(highest, frequencies, numSamples);
+        } else {
+            generateDpw<true, kNumVectors>(lowest, frequencies, numSamples);
+        }
+        countOutput(numSamples);
+    }
+
+private:
+    /**
+     * Render with kVectors SIMD vectors, or fewer if that is all the
+     * oscillators need. Every count gets its own instantiation so that the
+     * vector loops have a fixed length and the state stays in registers.
+     *
+     * @param frequency the frequency, or the lowest magnitude in
+     *     frequencies when kVarying
+     */
+    template <bool kVarying, int32_t kVectors>
+    void generateDpw(synth_float_t frequency, const synth_float_t *frequencies,
+                     int32_t numSamples) {
+        if constexpr (kVectors > 1) {
+            if (mNumVectors < kVectors) {
+                generateDpw<kVarying, kVectors - 1>(frequency, frequencies,
+                                                    numSamples);
+                return;
+            }
+        }
+        constexpr int32_t numVectors = kVectors;
+        constexpr int32_t numLanes = numVectors * SimdFloat::kWidth;
+        alignas(32) synth_float_t dpwScale[numLanes];
+        alignas(32) synth_float_t rawScale[numLanes];
+        alignas(32) synth_float_t increment[numLanes];
+        calculateIncrements(frequency, numLanes, increment, dpwScale, rawScale);
+        // Per Hz and per 1 / Hz versions for a varying frequency. A lane
+        // that is raw at the lowest frequency stays raw for the block.
+        alignas(32) synth_float_t incrementPerHz[numLanes];
+        alignas(32) synth_float_t scalePerInverseHz[numLanes];
+        bool anyDpw = false;
+        if (kVarying) {
+            const synth_float_t samplePeriod = getSamplePeriod();
+            for (int32_t lane = 0; lane < numLanes; lane++) {
+                incrementPerHz[lane] = 2.0f * mDetune[lane] * samplePeriod;
+                scalePerInverseHz[lane] = dpwScale[lane] * frequency;
+                anyDpw |= (dpwScale[lane] != 0.0f);
+                increment[lane] = frequencies[0] * incrementPerHz[lane];
+            }
+        }
+        if (mPrimeDelayLines) {
+            primeDelayLines(increment, numLanes);
+        }
+
+        const SimdFloat one = SimdFloat::broadcast(1.0f);
+        const SimdFloat two = SimdFloat::broadcast(2.0f);
+        SimdFloat phase[numVectors];
+        SimdFloat z1[numVectors];
+        SimdFloat z2[numVectors];
+        SimdFloat inc[numVectors];
+        SimdFloat scale[numVectors];
+        SimdFloat raw[numVectors];
+        SimdFloat gain[numVectors];
+        SimdFloat incPerHz[numVectors];
+        SimdFloat scalePerInvHz[numVectors];
+        for (int32_t v = 0; v < numVectors; v++) {
+            const int32_t lane = v * SimdFloat::kWidth;
+            phase[v] = SimdFloat::load(mPhase + lane);
+            z1[v] = SimdFloat::load(mZ1 + lane);
+            z2[v] = SimdFloat::load(mZ2 + lane);
+            inc[v] = SimdFloat::load(increment + lane);
+            scale[v] = SimdFloat::load(dpwScale + lane);
+            raw[v] = SimdFloat::load(rawScale + lane);
+            gain[v] = SimdFloat::load(mGain + lane);
+            if (kVarying) {
+                incPerHz[v] = SimdFloat::load(incrementPerHz + lane);
+                scalePerInvHz[v] = SimdFloat::load(scalePerInverseHz + lane);
+            }
+        }
+
+        alignas(32) synth_float_t lanes[SimdFloat::kWidth];
+        for (int32_t i = 0; i < numSamples; i++) {
+            if (kVarying) {
+                const synth_float_t hz = frequencies[i];
+                // One division per sample, shared by all of the lanes.
+                const synth_float_t inverse = !anyDpw ? 0.0f
+                        : 1.0f / ((hz < 0.0f) ? 0.0f - hz : hz);
+                const SimdFloat vectorHz = SimdFloat::broadcast(hz);
+                const SimdFloat vectorInverse = SimdFloat::broadcast(inverse);
+                for (int32_t v = 0; v < numVectors; v++) {
+                    inc[v] = incPerHz[v] * vectorHz;
+                    scale[v] = scalePerInvHz[v] * vectorInverse;
+                }
+            }
+            SimdFloat mix = SimdFloat::broadcast(0.0f);
+            for (int32_t v = 0; v < numVectors; v++) {
+                // Differentiate the parabola using a two sample delay, or
+                // pass the raw phase through for very low frequencies.
+                SimdFloat squared = phase[v] * phase[v];
+                SimdFloat saw = ((squared - z2[v]) * scale[v])
+                        + (phase[v] * raw[v]);
+                z2[v] = z1[v];
+                z1[v] = squared;
+                mix = mix + (saw * gain[v]);
+                phase[v] = (phase[v] + inc[v]).subtractIfGreater(one, two);
+            }
+            mix.store(lanes);
+            synth_float_t sum = 0;
+            for (int32_t lane = 0; lane < SimdFloat::kWidth; lane++) {
+                sum += lanes[lane];
+            }
+            output[i] = sum;
+        }
+
+        for (int32_t v = 0; v < numVectors; v++) {
+            const int32_t lane = v * SimdFloat::kWidth;
+            phase[v].store(mPhase + lane);
+            z1[v].store(mZ1 + lane);
+            z2[v].store(mZ2 + lane);
+        }
+    }
+
+    /**
+     * Mix the oscillators one at a time. Each one uses the table level that
+     * suits its own detuned frequency.
+     *
+     * @param frequency the frequency, or the highest magnitude in
+     *     frequencies when kVarying
+     */
+    template <bool kVarying>
+    void generateWavetable(synth_float_t frequency,
+                           const synth_float_t *frequencies,
+                           int32_t numSamples) {
+        const synth_float_t samplePeriod = getSamplePeriod();
+        SynthTools::fillBuffer(output, numSamples, 0.0f);
+        for (int32_t lane = 0; lane < mNumOscillators; lane++) {
+            const synth_float_t gain = mGain[lane];
+            if (gain == 0.0f) {
+                continue;
+            }
+            const synth_float_t incrementPerHz =
+                    2.0f * mDetune[lane] * samplePeriod;
+            const synth_float_t phaseIncrement =
+                    2.0f * frequency * mDetune[lane] * samplePeriod;
+            const SawtoothWavetable::Level &level = mWavetable->getLevel(
+                    SawtoothWavetable::selectLevel(phaseIncrement));
+            synth_float_t phase = mPhase[lane];
+            for (int32_t i = 0; i < numSamples; i++) {
+                output[i] += gain * SawtoothWavetable::lookup(level, phase);
+                phase += kVarying ? frequencies[i] * incrementPerHz
+                                  : phaseIncrement;
+                if (phase > 1.0f) {
+                    phase -= 2.0f;
+                }
+            }
+            mPhase[lane] = phase;
+        }
+    }
+
+    void calculateIncrements(synth_float_t frequency,
+                             int32_t numLanes,
+                             synth_float_t *increment,
+                             synth_float_t *dpwScale,
+                             synth_float_t *rawScale) {
+        const synth_float_t samplePeriod = getSamplePeriod();
+        const synth_float_t veryLowIncrement =
+                mContext->getDpwVeryLowIncrement();
+        for (int32_t lane = 0; lane < numLanes; lane++) {
+            synth_float_t phaseIncrement =
+                    2.0f * frequency * mDetune[lane] * samplePeriod;
+            increment[lane] = phaseIncrement;
+            synth_float_t positiveIncrement = (phaseIncrement < 0.0f)
+                    ? 0.0f - phaseIncrement
+                    : phaseIncrement;
+            // Same threshold as DifferentiatedParabola. Below it the DPW
+            // scaling blows up, so use the raw sawtooth instead.
+            if (positiveIncrement < veryLowIncrement) {
+                dpwScale[lane] = 0.0f;
+                rawScale[lane] = 1.0f;
+            } else {
+                dpwScale[lane] = 0.25f / positiveIncrement;
+                rawScale[lane] = 0.0f;
+            }
+        }
+    }
+
+    /**
+     * Fill the DPW delay lines as if the oscillators had already been
+     * running at this frequency. Otherwise the first samples after a phase
+     * jump produce a large spike. Only the lanes in use are primed,
+     * setOscillators() asks again when it adds more.
+     */
+    void primeDelayLines(const synth_float_t *increment, int32_t numLanes) {
+        for (int32_t lane = 0; lane < numLanes; lane++) {
+            synth_float_t previous = mPhase[lane] - increment[lane];
+            synth_float_t beforePrevious = previous - increment[lane];
+            mZ1[lane] = previous * previous;
+            mZ2[lane] = beforePrevious * beforePrevious;
+        }
+        mPrimeDelayLines = false;
+    }
+
+    alignas(32) synth_float_t mPhase[kNumLanes]; // between -1.0 and +1.0
+    alignas(32) synth_float_t mZ1[kNumLanes];    // DPW delay lines
+    alignas(32) synth_float_t mZ2[kNumLanes];
+    alignas(32) synth_float_t mDetune[kNumLanes];
+    alignas(32) synth_float_t mGain[kNumLanes];
+    int32_t mNumOscillators = 0;
+    int32_t mNumVectors = 0;
+    bool mPrimeDelayLines = false;
+    Source mSource = DPW;
+    const SawtoothWavetable *mWavetable = nullptr;
+};
+
+#endif // SYNTHMARK_SUPERSAW_OSCILLATOR_BANK_H
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SYNTH_EVENT_QUEUE_H
+#define SYNTHMARK_SYNTH_EVENT_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include "SynthMark.h"
+
+// Must be a power of two.
+#ifndef SYNTH_EVENT_QUEUE_CAPACITY
+#define SYNTH_EVENT_QUEUE_CAPACITY  256
+#endif
+
+/**
+ * A MIDI style event with the frame at which it should take effect.
+ */
+struct SynthEvent {
+    enum Type : uint8_t {
+        kNoteOn,
+        kNoteOff,
+        kControlChange,
+        kFilterCutoff,
+    };
+
+    // Position in the output of Synthesizer::render. Events whose time has
+    // already passed are applied at the start of the next frame rendered.
+    int64_t frameTime;
+    Type type;
+    uint8_t data1;  // pitch or controller number
+    uint8_t data2;  // controller value
+};
+
+/**
+ * Lock free single producer, single consumer ring of SynthEvents.
+ *
+ * One thread may call push() while another calls peek() and pop(). Events
+ * are consumed in the order they were pushed, so the producer should push
+ * them in non-decreasing frameTime order.
+ */
+class SynthEventQueue
+{
+public:
+    static constexpr uint32_t kCapacity = SYNTH_EVENT_QUEUE_CAPACITY;
+    static_assert((kCapacity & (kCapacity - 1)) == 0,
+                  "SYNTH_EVENT_QUEUE_CAPACITY must be a power of two");
+
+    /**
+     * @return false if the queue is full and the event was dropped
+     */
+    bool push(const SynthEvent &event) {
+        uint32_t write = mWriteIndex.load(std::memory_order_relaxed);
+        uint32_t read = mReadIndex.load(std::memory_order_acquire);
+        if (write - read == kCapacity) {
+            return false;
+        }
+        mEvents[write & (kCapacity - 1)] = event;
+        mWriteIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Look at the oldest event without removing it.
+     *
+     * @return false if the queue is empty
+     */
+    bool peek(SynthEvent *event) const {
+        uint32_t read = mReadIndex.load(std::memory_order_relaxed);
+        uint32_t write = mWriteIndex.load(std::memory_order_acquire);
+        if (read == write) {
+            return false;
+        }
+        *event = mEvents[read & (kCapacity - 1)];
+        return true;
+    }
+
+    /**
+     * Remove the event returned by the last successful peek().
+     */
+    void pop() {
+        uint32_t read = mReadIndex.load(std::memory_order_relaxed);
+        mReadIndex.store(read + 1, std::memory_order_release);
+    }
+
+private:
+    SynthEvent mEvents[kCapacity];
+    // Free running counters. The difference is the number of queued events.
+    std::atomic<uint32_t> mWriteIndex{0};
+    std::atomic<uint32_t> mReadIndex{0};
+};
+
+#endif // SYNTHMARK_SYNTH_EVENT_QUEUE_H
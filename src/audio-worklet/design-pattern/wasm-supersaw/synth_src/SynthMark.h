@@ -39,6 +39,12 @@
 #define SYNTHMARK_FRAMES_PER_RENDER    8
 #endif
 
+// The largest block that a unit generator can synthesize at one time.
+// This is one Web Audio render quantum.
+#ifndef SYNTHMARK_MAX_FRAMES_PER_RENDER
+#define SYNTHMARK_MAX_FRAMES_PER_RENDER    128
+#endif
+
 // The number of frames that are consumed by DMA or a mixer at one time.
 #ifndef SYNTHMARK_FRAMES_PER_BURST
 #define SYNTHMARK_FRAMES_PER_BURST     192
@@ -65,6 +71,9 @@
 
 typedef float synth_float_t;
 
+// Forces inlining of small per sample helpers into their loops.
+#define SYNTHMARK_ALWAYS_INLINE inline __attribute__((always_inline))
+
 /**
  * A fractional amplitude corresponding to exactly -96 dB.
  * amplitude = pow(10.0, db/20.0)
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SYNTH_RANDOM_H
+#define SYNTHMARK_SYNTH_RANDOM_H
+
+#include <cstdint>
+#include "SynthMark.h"
+
+#define SYNTH_RANDOM_DEFAULT_SEED  99887766
+
+/**
+ * Pseudo random number generator with its own state. Give each voice its
+ * own generator, so voices can be rendered on separate threads and a seed
+ * always gives the same sound.
+ *
+ * This runs kNumLanes independent xoshiro128++ generators side by side.
+ * Each step updates all of the lanes with the same integer operations, which
+ * the compiler turns into SIMD instructions, and yields kNumLanes numbers.
+ * The lane count does not depend on the SIMD width, so a seed gives the same
+ * sequence on every build. The block fills drop the numbers left over from
+ * their last step, so fill multiples of kNumLanes samples to get the same
+ * sequence for any block size.
+ */
+class SynthRandom
+{
+public:
+    static constexpr int32_t kNumLanes = 8;
+
+    explicit SynthRandom(uint64_t seed = SYNTH_RANDOM_DEFAULT_SEED) {
+        setSeed(seed);
+    }
+
+    /**
+     * Restart the sequence. Nearby seeds give unrelated sequences.
+     */
+    void setSeed(uint64_t seed) {
+        // Fill the state with SplitMix64, as the xoshiro authors recommend,
+        // so that it is never all zero.
+        for (int32_t lane = 0; lane < kNumLanes; lane++) {
+            uint64_t low = splitMix64(&seed);
+            uint64_t high = splitMix64(&seed);
+            mState0[lane] = (uint32_t) low;
+            mState1[lane] = (uint32_t) (low >> 32);
+            mState2[lane] = (uint32_t) high;
+            mState3[lane] = (uint32_t) (high >> 32);
+        }
+        mNextLane = kNumLanes;
+    }
+
+    /**
+     * @return a random 32 bit number
+     */
+    uint32_t nextInteger() {
+        if (mNextLane == kNumLanes) {
+            step(mIntegers);
+            mNextLane = 0;
+        }
+        return mIntegers[mNextLane++];
+    }
+
+    /**
+     * @return a random double from 0.0 up to but not including 1.0
+     */
+    double nextDouble() {
+        const double scaler = 1.0 / (((uint64_t)1) << 32);
+        return nextInteger() * scaler;
+    }
+
+    /**
+     * Fill a buffer with random values from 0.0 up to but not including 1.0.
+     */
+    void fillUniform(synth_float_t *output, int32_t numSamples) {
+        fill(output, numSamples, 0.0f);
+    }
+
+    /**
+     * Fill a buffer with random values from -1.0 up to but not including 1.0.
+     */
+    void fillBipolar(synth_float_t *output, int32_t numSamples) {
+        fill(output, numSamples, 1.0f);
+    }
+
+private:
+    static uint64_t splitMix64(uint64_t *state) {
+        uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    static uint32_t rotateLeft(uint32_t x, int32_t bits) {
+        return (x << bits) | (x >> (32 - bits));
+    }
+
+    // Advance every lane by one xoshiro128++ step.
+    void step(uint32_t *integers) {
+        for (int32_t lane = 0; lane < kNumLanes; lane++) {
+            integers[lane] = rotateLeft(mState0[lane] + mState3[lane], 7)
+                    + mState0[lane];
+            const uint32_t shifted = mState1[lane] << 9;
+            mState2[lane] ^= mState0[lane];
+            mState3[lane] ^= mState1[lane];
+            mState1[lane] ^= mState2[lane];
+            mState0[lane] ^= mState3[lane];
+            mState2[lane] ^= shifted;
+            mState3[lane] = rotateLeft(mState3[lane], 11);
+        }
+    }
+
+    // Fill with values from -offset up to but not including 1.0.
+    void fill(synth_float_t *output, int32_t numSamples, synth_float_t offset) {
+        // The top 24 bits fit a float exactly, so 1.0 is never reached.
+        const synth_float_t scaler = (1.0f + offset) / (1 << 24);
+        alignas(32) uint32_t integers[kNumLanes];
+        int32_t i = 0;
+        while (i < numSamples) {
+            step(integers);
+            const int32_t count = (numSamples - i < kNumLanes)
+                    ? numSamples - i : kNumLanes;
+            for (int32_t lane = 0; lane < count; lane++) {
+                output[i + lane] = ((synth_float_t) (integers[lane] >> 8)
+                        * scaler) - offset;
+            }
+            i += count;
+        }
+    }
+
+    alignas(32) uint32_t mState0[kNumLanes];
+    alignas(32) uint32_t mState1[kNumLanes];
+    alignas(32) uint32_t mState2[kNumLanes];
+    alignas(32) uint32_t mState3[kNumLanes];
+    // Numbers already generated for nextInteger().
+    alignas(32) uint32_t mIntegers[kNumLanes];
+    int32_t mNextLane = kNumLanes;
+};
+
+#endif // SYNTHMARK_SYNTH_RANDOM_H
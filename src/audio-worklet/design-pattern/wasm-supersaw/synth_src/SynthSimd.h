@@ -0,0 +1,259 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_SYNTH_SIMD_H
+#define SYNTHMARK_SYNTH_SIMD_H
+
+#include <cstdint>
+#include <math.h>
+#include "SynthMark.h"
+
+/**
+ * Minimal portable float vector used by the block kernels.
+ *
+ * The instruction set is chosen when compiling:
+ *   AVX2         8 lanes (native, -mavx2 or -march=native)
+ *   SSE2         4 lanes (native x86-64 default)
+ *   simd128      4 lanes (wasm, -msimd128)
+ *   otherwise    1 lane, plain C++
+ * Define SYNTHMARK_DISABLE_SIMD to force the scalar path.
+ *
+ * Only operations that round exactly like their scalar equivalents are
+ * provided, so a kernel gives bit identical results on every path as long as
+ * the compiler is not allowed to contract a*b+c into a fused multiply-add.
+ *
+ * subtractIfGreater() subtracts amount from the lanes that are above limit.
+ * It is used to wrap oscillator phases without branching. zeroIfSmaller()
+ * clears the lanes whose magnitude is below threshold, and NaN lanes, see
+ * DenormalGuard.
+ *
+ * interpolate() reads a table at a fractional, non-negative position in each
+ * lane and interpolates linearly. AVX2 gathers the table entries, the other
+ * paths load them one lane at a time.
+ *
+ * floor(), powerOfTwo() and splitExponent() take floats apart for FastMath.
+ * floor() needs lanes below 2^31 in magnitude, powerOfTwo() whole numbers
+ * from -126 to +127 and splitExponent() positive normal numbers. The
+ * mantissa from splitExponent() is between 1.0 and 2.0.
+ */
+
+#if defined(SYNTHMARK_DISABLE_SIMD)
+#define SYNTHMARK_SIMD_NAME "scalar"
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SYNTHMARK_SIMD_AVX2 1
+#define SYNTHMARK_SIMD_NAME "avx2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SYNTHMARK_SIMD_SSE2 1
+#define SYNTHMARK_SIMD_NAME "sse2"
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define SYNTHMARK_SIMD_WASM 1
+#define SYNTHMARK_SIMD_NAME "wasm-simd128"
+#else
+#define SYNTHMARK_SIMD_NAME "scalar"
+#endif
+
+class SimdFloat
+{
+public:
+#if defined(SYNTHMARK_SIMD_AVX2)
+    typedef __m256 Native;
+    static constexpr int32_t kWidth = 8;
+
+    static SimdFloat load(const float *p) { return _mm256_loadu_ps(p); }
+    static SimdFloat broadcast(float x) { return _mm256_set1_ps(x); }
+    void store(float *p) const { _mm256_storeu_ps(p, v); }
+    SimdFloat operator+(SimdFloat b) const { return _mm256_add_ps(v, b.v); }
+    SimdFloat operator-(SimdFloat b) const { return _mm256_sub_ps(v, b.v); }
+    SimdFloat operator*(SimdFloat b) const { return _mm256_mul_ps(v, b.v); }
+    SimdFloat operator/(SimdFloat b) const { return _mm256_div_ps(v, b.v); }
+    SimdFloat floor() const { return _mm256_floor_ps(v); }
+    static SimdFloat powerOfTwo(SimdFloat wholeNumber) {
+        __m256i exponent = _mm256_add_epi32(_mm256_cvttps_epi32(wholeNumber.v),
+                                            _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(exponent, 23));
+    }
+    SimdFloat splitExponent(SimdFloat *exponent) const {
+        __m256i bits = _mm256_castps_si256(v);
+        exponent->v = _mm256_cvtepi32_ps(_mm256_sub_epi32(
+                _mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        return _mm256_castsi256_ps(_mm256_or_si256(
+                _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                _mm256_set1_epi32(0x3f800000)));
+    }
+    SimdFloat min(SimdFloat b) const { return _mm256_min_ps(v, b.v); }
+    SimdFloat max(SimdFloat b) const { return _mm256_max_ps(v, b.v); }
+    SimdFloat subtractIfGreater(SimdFloat limit, SimdFloat amount) const {
+        __m256 mask = _mm256_cmp_ps(v, limit.v, _CMP_GT_OQ);
+        return _mm256_sub_ps(v, _mm256_and_ps(mask, amount.v));
+    }
+    SimdFloat zeroIfSmaller(SimdFloat threshold) const {
+        __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+        return _mm256_and_ps(
+                _mm256_cmp_ps(magnitude, threshold.v, _CMP_GE_OQ), v);
+    }
+    static SimdFloat interpolate(const float *table, SimdFloat position) {
+        __m256i index = _mm256_cvttps_epi32(position.v);
+        __m256 fraction = _mm256_sub_ps(position.v, _mm256_cvtepi32_ps(index));
+        __m256 base = _mm256_i32gather_ps(table, index, 4);
+        __m256 next = _mm256_i32gather_ps(table + 1, index, 4);
+        return _mm256_add_ps(base,
+                _mm256_mul_ps(fraction, _mm256_sub_ps(next, base)));
+    }
+#elif defined(SYNTHMARK_SIMD_SSE2)
+    typedef __m128 Native;
+    static constexpr int32_t kWidth = 4;
+
+    static SimdFloat load(const float *p) { return _mm_loadu_ps(p); }
+    static SimdFloat broadcast(float x) { return _mm_set1_ps(x); }
+    void store(float *p) const { _mm_storeu_ps(p, v); }
+    SimdFloat operator+(SimdFloat b) const { return _mm_add_ps(v, b.v); }
+    SimdFloat operator-(SimdFloat b) const { return _mm_sub_ps(v, b.v); }
+    SimdFloat operator*(SimdFloat b) const { return _mm_mul_ps(v, b.v); }
+    SimdFloat operator/(SimdFloat b) const { return _mm_div_ps(v, b.v); }
+    SimdFloat floor() const {
+        // SSE2 has no floor, so truncate and step down the negative lanes.
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        __m128 tooHigh = _mm_cmpgt_ps(truncated, v);
+        return _mm_sub_ps(truncated, _mm_and_ps(tooHigh, _mm_set1_ps(1.0f)));
+    }
+    static SimdFloat powerOfTwo(SimdFloat wholeNumber) {
+        __m128i exponent = _mm_add_epi32(_mm_cvttps_epi32(wholeNumber.v),
+                                         _mm_set1_epi32(127));
+        return _mm_castsi128_ps(_mm_slli_epi32(exponent, 23));
+    }
+    SimdFloat splitExponent(SimdFloat *exponent) const {
+        __m128i bits = _mm_castps_si128(v);
+        exponent->v = _mm_cvtepi32_ps(_mm_sub_epi32(
+                _mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        return _mm_castsi128_ps(_mm_or_si128(
+                _mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                _mm_set1_epi32(0x3f800000)));
+    }
+    SimdFloat min(SimdFloat b) const { return _mm_min_ps(v, b.v); }
+    SimdFloat max(SimdFloat b) const { return _mm_max_ps(v, b.v); }
+    SimdFloat subtractIfGreater(SimdFloat limit, SimdFloat amount) const {
+        __m128 mask = _mm_cmpgt_ps(v, limit.v);
+        return _mm_sub_ps(v, _mm_and_ps(mask, amount.v));
+    }
+    SimdFloat zeroIfSmaller(SimdFloat threshold) const {
+        __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+        return _mm_and_ps(_mm_cmpge_ps(magnitude, threshold.v), v);
+    }
+    static SimdFloat interpolate(const float *table, SimdFloat position) {
+        __m128i index = _mm_cvttps_epi32(position.v);
+        __m128 fraction = _mm_sub_ps(position.v, _mm_cvtepi32_ps(index));
+        alignas(16) int32_t lanes[kWidth];
+        _mm_store_si128((__m128i *) lanes, index);
+        __m128 base = _mm_setr_ps(table[lanes[0]], table[lanes[1]],
+                                  table[lanes[2]], table[lanes[3]]);
+        __m128 next = _mm_setr_ps(table[lanes[0] + 1], table[lanes[1] + 1],
+                                  table[lanes[2] + 1], table[lanes[3] + 1]);
+        return _mm_add_ps(base, _mm_mul_ps(fraction, _mm_sub_ps(next, base)));
+    }
+#elif defined(SYNTHMARK_SIMD_WASM)
+    typedef v128_t Native;
+    static constexpr int32_t kWidth = 4;
+
+    static SimdFloat load(const float *p) { return wasm_v128_load(p); }
+    static SimdFloat broadcast(float x) { return wasm_f32x4_splat(x); }
+    void store(float *p) const { wasm_v128_store(p, v); }
+    SimdFloat operator+(SimdFloat b) const { return wasm_f32x4_add(v, b.v); }
+    SimdFloat operator-(SimdFloat b) const { return wasm_f32x4_sub(v, b.v); }
+    SimdFloat operator*(SimdFloat b) const { return wasm_f32x4_mul(v, b.v); }
+    SimdFloat operator/(SimdFloat b) const { return wasm_f32x4_div(v, b.v); }
+    SimdFloat floor() const { return wasm_f32x4_floor(v); }
+    static SimdFloat powerOfTwo(SimdFloat wholeNumber) {
+        v128_t exponent = wasm_i32x4_add(wasm_i32x4_trunc_sat_f32x4(wholeNumber.v),
+                                         wasm_i32x4_splat(127));
+        return wasm_i32x4_shl(exponent, 23);
+    }
+    SimdFloat splitExponent(SimdFloat *exponent) const {
+        exponent->v = wasm_f32x4_convert_i32x4(wasm_i32x4_sub(
+                wasm_u32x4_shr(v, 23), wasm_i32x4_splat(127)));
+        return wasm_v128_or(wasm_v128_and(v, wasm_i32x4_splat(0x007fffff)),
+                            wasm_i32x4_splat(0x3f800000));
+    }
+    SimdFloat min(SimdFloat b) const { return wasm_f32x4_min(v, b.v); }
+    SimdFloat max(SimdFloat b) const { return wasm_f32x4_max(v, b.v); }
+    SimdFloat subtractIfGreater(SimdFloat limit, SimdFloat amount) const {
+        v128_t mask = wasm_f32x4_gt(v, limit.v);
+        return wasm_f32x4_sub(v, wasm_v128_and(mask, amount.v));
+    }
+    SimdFloat zeroIfSmaller(SimdFloat threshold) const {
+        return wasm_v128_and(wasm_f32x4_ge(wasm_f32x4_abs(v), threshold.v), v);
+    }
+    static SimdFloat interpolate(const float *table, SimdFloat position) {
+        v128_t index = wasm_i32x4_trunc_sat_f32x4(position.v);
+        v128_t fraction = wasm_f32x4_sub(position.v,
+                                         wasm_f32x4_convert_i32x4(index));
+        const int32_t i0 = wasm_i32x4_extract_lane(index, 0);
+        const int32_t i1 = wasm_i32x4_extract_lane(index, 1);
+        const int32_t i2 = wasm_i32x4_extract_lane(index, 2);
+        const int32_t i3 = wasm_i32x4_extract_lane(index, 3);
+        v128_t base = wasm_f32x4_make(table[i0], table[i1],
+                                      table[i2], table[i3]);
+        v128_t next = wasm_f32x4_make(table[i0 + 1], table[i1 + 1],
+                                      table[i2 + 1], table[i3 + 1]);
+        return wasm_f32x4_add(base,
+                wasm_f32x4_mul(fraction, wasm_f32x4_sub(next, base)));
+    }
+#else
+    typedef float Native;
+    static constexpr int32_t kWidth = 1;
+
+    static SimdFloat load(const float *p) { return *p; }
+    static SimdFloat broadcast(float x) { return x; }
+    void store(float *p) const { *p = v; }
+    SimdFloat operator+(SimdFloat b) const { return v + b.v; }
+    SimdFloat operator-(SimdFloat b) const { return v - b.v; }
+    SimdFloat operator*(SimdFloat b) const { return v * b.v; }
+    SimdFloat operator/(SimdFloat b) const { return v / b.v; }
+    SimdFloat floor() const { return floorf(v); }
+    static SimdFloat powerOfTwo(SimdFloat wholeNumber) {
+        return ldexpf(1.0f, (int) wholeNumber.v);
+    }
+    SimdFloat splitExponent(SimdFloat *exponent) const {
+        int whole;
+        float mantissa = frexpf(v, &whole);
+        exponent->v = (float) (whole - 1);
+        return mantissa * 2.0f;
+    }
+    SimdFloat min(SimdFloat b) const { return (b.v < v) ? b.v : v; }
+    SimdFloat max(SimdFloat b) const { return (b.v > v) ? b.v : v; }
+    SimdFloat subtractIfGreater(SimdFloat limit, SimdFloat amount) const {
+        return (v > limit.v) ? v - amount.v : v;
+    }
+    SimdFloat zeroIfSmaller(SimdFloat threshold) const {
+        return (fabsf(v) >= threshold.v) ? v : 0.0f;
+    }
+    static SimdFloat interpolate(const float *table, SimdFloat position) {
+        int32_t index = (int32_t) position.v;
+        float fraction = position.v - (float) index;
+        float base = table[index];
+        return base + (fraction * (table[index + 1] - base));
+    }
+#endif
+
+    SimdFloat() = default;
+    SimdFloat(Native value) : v(value) {}
+
+    Native v;
+};
+
+#endif // SYNTHMARK_SYNTH_SIMD_H
@@ -20,6 +20,14 @@
 #ifndef SYNTHMARK_SYNTHTOOLS_H
 #define SYNTHMARK_SYNTHTOOLS_H
 
+#include "SynthSimd.h"
+#include "FastMath.h"
+
+/**
+ * The buffer kernels below process SimdFloat::kWidth samples at a time and
+ * finish the remainder with a scalar loop. Each lane performs exactly the
+ * same float operations as the scalar loop so the results are bit identical.
+ */
 
 class SynthTools
 {
@@ -28,8 +36,13 @@ public:
     static void fillBuffer(synth_float_t *output,
                                   int32_t numSamples,
                                   synth_float_t value) {
-        for (int i = 0; i < numSamples; i++) {
-            *output++ = value;
+        int32_t i = 0;
+        const SimdFloat vectorValue = SimdFloat::broadcast(value);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            vectorValue.store(output + i);
+        }
+        for (; i < numSamples; i++) {
+            output[i] = value;
         }
     }
 
@@ -37,8 +50,13 @@ public:
                                   synth_float_t *output,
                                   int32_t numSamples,
                                   synth_float_t multiplier) {
-        for (int i = 0; i < numSamples; i++) {
-            *output++ = *input++ * multiplier;
+        int32_t i = 0;
+        const SimdFloat vectorMultiplier = SimdFloat::broadcast(multiplier);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            (SimdFloat::load(input + i) * vectorMultiplier).store(output + i);
+        }
+        for (; i < numSamples; i++) {
+            output[i] = input[i] * multiplier;
         }
     }
 
@@ -47,8 +65,15 @@ public:
                                   int32_t numSamples,
                                   synth_float_t multiplier,
                                   synth_float_t offset) {
-        for (int i = 0; i < numSamples; i++) {
-            *output++ = (*input++ * multiplier) + offset;
+        int32_t i = 0;
+        const SimdFloat vectorMultiplier = SimdFloat::broadcast(multiplier);
+        const SimdFloat vectorOffset = SimdFloat::broadcast(offset);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            ((SimdFloat::load(input + i) * vectorMultiplier) + vectorOffset)
+                    .store(output + i);
+        }
+        for (; i < numSamples; i++) {
+            output[i] = (input[i] * multiplier) + offset;
         }
     }
 
@@ -58,17 +83,33 @@ public:
                            synth_float_t gain2,
                            synth_float_t *output,
                            int32_t numSamples) {
-        for (int i = 0; i < numSamples; i++) {
-            *output++ = (*input1++ * gain1) + (*input2++ * gain2);
+        int32_t i = 0;
+        const SimdFloat vectorGain1 = SimdFloat::broadcast(gain1);
+        const SimdFloat vectorGain2 = SimdFloat::broadcast(gain2);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            ((SimdFloat::load(input1 + i) * vectorGain1)
+                    + (SimdFloat::load(input2 + i) * vectorGain2))
+                    .store(output + i);
+        }
+        for (; i < numSamples; i++) {
+            output[i] = (input1[i] * gain1) + (input2[i] * gain2);
         }
     }
 
+    /**
+     * Multiply two buffers sample by sample, eg. to apply an envelope.
+     */
     static void multiplyBuffers(const synth_float_t *input1,
                                        const synth_float_t *input2,
                                        synth_float_t *output,
                                        int32_t numSamples) {
-        for (int i = 0; i < numSamples; i++) {
-            *output++ = *input1++ * *input2;
+        int32_t i = 0;
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            (SimdFloat::load(input1 + i) * SimdFloat::load(input2 + i))
+                    .store(output + i);
+        }
+        for (; i < numSamples; i++) {
+            output[i] = input1[i] * input2[i];
         }
     }
 
@@ -76,11 +117,79 @@ public:
                            synth_float_t gain,
                            synth_float_t *destination,
                            int32_t numSamples) {
-        for (int i = 0; i < numSamples; i++) {
-            *destination++ += (*source++ * gain);
+        int32_t i = 0;
+        const SimdFloat vectorGain = SimdFloat::broadcast(gain);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            (SimdFloat::load(destination + i)
+                    + (SimdFloat::load(source + i) * vectorGain))
+                    .store(destination + i);
+        }
+        for (; i < numSamples; i++) {
+            destination[i] += (source[i] * gain);
+        }
+    }
+
+    /**
+     * Linear ramp, output[i] = start + (i * increment).
+     * Each sample is computed from i so rounding does not accumulate.
+     */
+    static void fillRamp(synth_float_t *output,
+                         int32_t numSamples,
+                         synth_float_t start,
+                         synth_float_t increment) {
+        int32_t i = 0;
+        alignas(32) synth_float_t laneIndex[SimdFloat::kWidth];
+        for (int32_t lane = 0; lane < SimdFloat::kWidth; lane++) {
+            laneIndex[lane] = (synth_float_t) lane;
+        }
+        SimdFloat index = SimdFloat::load(laneIndex);
+        const SimdFloat vectorWidth = SimdFloat::broadcast(
+                (synth_float_t) SimdFloat::kWidth);
+        const SimdFloat vectorStart = SimdFloat::broadcast(start);
+        const SimdFloat vectorIncrement = SimdFloat::broadcast(increment);
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            (vectorStart + (index * vectorIncrement)).store(output + i);
+            index = index + vectorWidth;
+        }
+        for (; i < numSamples; i++) {
+            output[i] = start + ((synth_float_t) i * increment);
         }
     }
 
+    /**
+     * Geometric series, output[i] = start * ratio^i, eg. an exponential
+     * decay. Each lane is advanced by ratio^kWidth per vector, so the result
+     * is close to, but not bit identical to, multiplying by ratio once per
+     * sample.
+     *
+     * @return start * ratio^numSamples, the value after the last sample
+     */
+    static synth_float_t fillGeometric(synth_float_t *output,
+                                       int32_t numSamples,
+                                       synth_float_t start,
+                                       synth_float_t ratio) {
+        alignas(32) synth_float_t lanes[SimdFloat::kWidth];
+        synth_float_t power = 1.0f;
+        for (int32_t lane = 0; lane < SimdFloat::kWidth; lane++) {
+            lanes[lane] = start * power;
+            power *= ratio;
+        }
+        // power is now ratio^kWidth
+        SimdFloat value = SimdFloat::load(lanes);
+        const SimdFloat step = SimdFloat::broadcast(power);
+        int32_t i = 0;
+        for (; i + SimdFloat::kWidth <= numSamples; i += SimdFloat::kWidth) {
+            value.store(output + i);
+            value = value * step;
+        }
+        value.store(lanes);
+        const int32_t remaining = numSamples - i;
+        for (int32_t lane = 0; lane < remaining; lane++) {
+            output[i + lane] = lanes[lane];
+        }
+        return (remaining > 0) ? lanes[remaining - 1] * ratio : lanes[0];
+    }
+
     static double convertTimeToExponentialScaler(synth_float_t duration, synth_float_t sampleRate) {
         // Calculate scaler so that scaler^frames = target/source
         double numFrames = duration * sampleRate;
@@ -88,77 +197,25 @@ public:
     }
 
     /**
-     * Calculate sine using a Taylor expansion.
-     * Code is based on SineOscillator from JSyn.
+     * Calculate sine with FastMath, which gives the same result in a SIMD
+     * lane, so block code can match this one sample at a time.
      *
      * @param phase between -PI and +PI
      */
     static synth_float_t fastSine(synth_float_t phase) {
-        // Factorial coefficients.
-        const synth_float_t IF3 = 1.0 / (2 * 3);
-        const synth_float_t IF5 = IF3 / (4 * 5);
-        const synth_float_t IF7 = IF5 / (6 * 7);
-        const synth_float_t IF9 = IF7 / (8 * 9);
-        const synth_float_t IF11 = IF9 / (10 * 11);
-
-        /* Wrap phase back into region where results are more accurate. */
-        synth_float_t x = (phase > M_PI_2) ? M_PI - phase
-        : ((phase < -M_PI_2) ? -(M_PI + phase) : phase);
-
-        synth_float_t x2 = (x * x);
-        /* Taylor expansion out to x**11/11! factored into multiply-adds */
-        return x * (x2 * (x2 * (x2 * (x2 * ((x2 * (-IF11)) + IF9) - IF7) + IF5) - IF3) + 1);
+        return FastMath::sin<FastMath::ACCURATE>(phase);
     }
 
     /**
-     * Calculate cosine using a Taylor expansion.
+     * Calculate cosine with FastMath.
      *
      * @param phase between -PI and +PI
      */
     static synth_float_t fastCosine(synth_float_t phase) {
-        // Factorial coefficients.
-        const synth_float_t IF2 = 1.0 / (2);
-        const synth_float_t IF4 = IF2 / (3 * 4);
-        const synth_float_t IF6 = IF4 / (5 * 6);
-        const synth_float_t IF8 = IF6 / (7 * 8);
-        const synth_float_t IF10 = IF8 / (9 * 10);
-
-        /* Wrap phase back into region where results are more accurate. */
-        synth_float_t x = phase;
-        if (x < 0.0) {
-             x = 0.0 - phase;
-        }
-        int negate = 1;
-        if (x > M_PI_2) {
-            x = M_PI_2 - x;
-            negate = -1;
-        }
-
-        synth_float_t x2 = (x * x);
-        /* Taylor expansion out to x**11/11! factored into multiply-adds */
-        synth_float_t cosine = 1 + (x2 * (x2 * (x2 * (x2 * ((x2 * (-IF10)) + IF8) - IF6) + IF4) - IF2));
-        return cosine * negate;
+        return FastMath::cos<FastMath::ACCURATE>(phase);
     }
 
 
-    /**
-     * Calculate random 32 bit number using linear-congruential method.
-     */
-    static uint32_t nextRandomInteger() {
-        static uint64_t seed = 99887766;
-        // Use values for 64-bit sequence from MMIX by Donald Knuth.
-        seed = (seed * 6364136223846793005L) + 1442695040888963407L;
-        return (uint32_t) (seed >> 32); // The higher bits have a longer sequence.
-    }
-
-    /**
-     * @return a random double between 0.0 and 1.0
-     */
-    static double nextRandomDouble() {
-        const double scaler = 1.0 / (((uint64_t)1) << 32);
-        return nextRandomInteger() * scaler;
-    }
-
     /**
      * Maps a MIDI value into a specified range.
      */
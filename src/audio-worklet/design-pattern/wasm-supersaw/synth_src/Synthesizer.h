@@ -17,65 +17,249 @@
 #ifndef SYNTHESIZER_H
 #define SYNTHESIZER_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <vector>
 
 #include "SynthMark.h"
 #include "SynthTools.h"
+#include "EngineContext.h"
+#include "RealtimeAudit.h"
+#include "DenormalGuard.h"
 #include "VoiceBase.h"
 #include "SimpleVoice.h"
+#include "SynthRandom.h"
+#include "SynthEventQueue.h"
+#include "VoiceAllocator.h"
+#include "VoiceRenderPool.h"
 
 class Synthesizer {
  public:
-  Synthesizer(int32_t sampleRate) {
-    UnitGenerator::setSampleRate(sampleRate);
-    mVoice = new SimpleVoice();
+  // Number of voices preallocated when no polyphony is requested.
+  static constexpr int32_t kDefaultMaxVoices = 16;
+
+  Synthesizer(int32_t sampleRate, int32_t maxVoices = kDefaultMaxVoices)
+      : mContext(sampleRate),
+        mVoices(maxVoices),
+        mRenderOrder(mVoices.getMaxVoices()) {
+    forEachVoice([this](SimpleVoice& voice) {
+      voice.setEngineContext(&mContext);
+    });
+    setRandomSeed(SYNTH_RANDOM_DEFAULT_SEED);
   }
 
+  // Voices point at mContext, so a Synthesizer cannot be copied.
+  Synthesizer(const Synthesizer&) = delete;
+  Synthesizer& operator=(const Synthesizer&) = delete;
+
   virtual ~Synthesizer() {};
 
-  void noteOn(uint8_t pitch) {
-    mPitches.push_back(static_cast<float>(pitch));
-    mVoice->setPitch(mPitches.back());
-    if (mPitches.size() == 1)
-      mVoice->start();
+  // Events are queued and applied by render() at their frame time, so these
+  // may be called from a different thread than render(). Each returns false
+  // if the event queue is full. The calls without a frame time are applied
+  // at the next frame rendered, even if scheduled events are still waiting.
+
+  bool noteOn(uint8_t pitch) {
+    return scheduleNoteOn(pitch, kImmediately);
+  }
+
+  bool noteOff(uint8_t pitch) {
+    return scheduleNoteOff(pitch, kImmediately);
+  }
+
+  bool controlChange(uint8_t control, uint8_t value) {
+    return scheduleControlChange(control, value, kImmediately);
+  }
+
+  // Takes a MIDI value from 0 to 127. Events carry whole MIDI values, so it
+  // is rounded to the nearest one, and values out of range or NaN are
+  // clamped.
+  bool setFilterCutoff(synth_float_t value) {
+    synth_float_t midiValue = (value > 0.0f) ? value : 0.0f;
+    midiValue = std::min(midiValue, 127.0f);
+    return postEvent(kImmediately, SynthEvent::kFilterCutoff,
+                     static_cast<uint8_t>(midiValue + 0.5f), 0);
+  }
+
+  /**
+   * Schedule events at a frame of the rendered output, see getFrameTime().
+   * Events must be scheduled in time order. Within a frame, immediate
+   * events are applied before scheduled ones.
+   */
+  bool scheduleNoteOn(uint8_t pitch, int64_t frameTime) {
+    return postEvent(frameTime, SynthEvent::kNoteOn, pitch, 0);
+  }
+
+  bool scheduleNoteOff(uint8_t pitch, int64_t frameTime) {
+    return postEvent(frameTime, SynthEvent::kNoteOff, pitch, 0);
+  }
+
+  bool scheduleControlChange(uint8_t control, uint8_t value,
+                             int64_t frameTime) {
+    return postEvent(frameTime, SynthEvent::kControlChange, control, value);
+  }
+
+  /**
+   * @return number of frames returned by render() so far. Only call this
+   *     from the thread that calls render().
+   */
+  int64_t getFrameTime() const {
+    return mFrameTime - (mMixFrames - mMixReadIndex);
+  }
+
+  int32_t getActiveVoiceCount() const {
+    return mVoices.getActiveCount();
+  }
+
+  int32_t getMaxVoices() const {
+    return mVoices.getMaxVoices();
+  }
+
+  /**
+   * Select how many frames are synthesized between control updates. Larger
+   * blocks have less overhead per frame but update glide and filter cutoff
+   * less often. Supported sizes are 8, 16, 32, 64 and 128. The new size
+   * takes effect after any frames already synthesized have been rendered.
+   *
+   * @return false if the size is not supported
+   */
+  bool setFramesPerBlock(int32_t framesPerBlock) {
+    switch (framesPerBlock) {
+      case 8:
+      case 16:
+      case 32:
+      case 64:
+      case 128:
+        mContext.setFramesPerBlock(framesPerBlock);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  int32_t getFramesPerBlock() const {
+    return mContext.getFramesPerBlock();
   }
 
-  void noteOff(uint8_t pitch) {
-    mPitches.erase(std::remove(mPitches.begin(), mPitches.end(),
-                               static_cast<float>(pitch)),
-        mPitches.end());
-    if (mPitches.size() >= 1)
-      mVoice->setPitch(mPitches.back());
-    if (mPitches.size() == 0)
-      mVoice->stop();
+  int32_t getSampleRate() const {
+    return mContext.getSampleRate();
   }
 
-  void setFilterCutoff(synth_float_t value){
-    mVoice->setFilterCutoff(
-        SynthTools::interpolateMIDIValue(value, 0, 8000.0));
+  /**
+   * Render the voices of each block on this many threads, including the
+   * one that calls render(). The output is bit identical for any count.
+   * Starts and stops threads, so do not call it while render() is running.
+   *
+   * @return false if threads are not available in this build
+   */
+  bool setRenderThreads(int32_t numThreads) {
+#if SYNTHMARK_HAS_THREADS
+    if (numThreads < 1 || numThreads > SYNTHMARK_MAX_RENDER_THREADS)
+      return false;
+    mRenderPool.reset();
+    if (numThreads > 1)
+      mRenderPool.reset(new VoiceRenderPool(numThreads));
+    return true;
+#else
+    return numThreads == 1;
+#endif
   }
 
-  void controlChange(uint8_t control, uint8_t value) {
-    setControlMode(static_cast<ControlMode>(control), value);
-    routeControlChange(control, value);
+  int32_t getRenderThreads() const {
+#if SYNTHMARK_HAS_THREADS
+    if (mRenderPool)
+      return mRenderPool->getNumThreads();
+#endif
+    return 1;
   }
 
+  /**
+   * Count denormal, NaN and infinite samples at each stage of every voice,
+   * see SimpleVoice::setSampleCounting(). Do not call it while render() is
+   * running.
+   */
+  void setSampleCounting(bool enabled) {
+    forEachVoice(
+        [=](SimpleVoice& voice) { voice.setSampleCounting(enabled); });
+  }
+
+  /**
+   * @return the counts for one stage, summed over the voices. Only call
+   *     this from the thread that calls render().
+   */
+  SampleCounters getSampleCounters(SimpleVoice::Stage stage) {
+    SampleCounters total;
+    forEachVoice([&](SimpleVoice& voice) {
+      total.add(voice.getSampleCounters(stage));
+    });
+    return total;
+  }
+
+  /**
+   * Restart the random sequences of the voices, so that the same seed and
+   * events render the same output. Each voice gets its own sequence. Do not
+   * call it while render() is running.
+   */
+  void setRandomSeed(uint64_t seed) {
+    for (int32_t i = 0; i < mVoices.getMaxVoices(); i++)
+      mVoices.getVoice(i).setRandomSeed(seed + i);
+  }
+
+  /**
+   * Render any number of frames. Frames of a block that do not fit into
+   * this call are kept and returned first by the next call.
+   */
   void render(float* output, int32_t numFrames) {
+    ScopedRealtimeSection realtime;
+    ScopedDenormalGuard denormals;
+    const int32_t framesPerBlock = mContext.getFramesPerBlock();
     int32_t framesLeft = numFrames;
-    while (framesLeft >= SYNTHMARK_FRAMES_PER_RENDER) {
-      mVoice->generate(SYNTHMARK_FRAMES_PER_RENDER);
-      for (int i = 0; i < SYNTHMARK_FRAMES_PER_RENDER; i++)
-        *output++ = static_cast<float>(mVoice->output[i]);
-      framesLeft -= SYNTHMARK_FRAMES_PER_RENDER;
+    while (framesLeft > 0) {
+      if (mMixReadIndex == mMixFrames) {
+        // Synthesize whole blocks straight into the output when possible.
+        if (framesLeft >= framesPerBlock) {
+          renderBlock(output);
+          output += framesPerBlock;
+          framesLeft -= framesPerBlock;
+          continue;
+        }
+        renderBlock(mMixBuffer);
+        mMixFrames = framesPerBlock;
+        mMixReadIndex = 0;
+      }
+      int32_t framesToCopy = std::min(framesLeft, mMixFrames - mMixReadIndex);
+      memcpy(output, mMixBuffer + mMixReadIndex, framesToCopy * sizeof(float));
+      mMixReadIndex += framesToCopy;
+      output += framesToCopy;
+      framesLeft -= framesToCopy;
     }
   }
 
+  /**
+   * Print the control mode and patch parameters requested with MIDI
+   * controllers since the last call. render() may not print, so call this
+   * periodically from a thread that is allowed to block.
+   */
+  void printStatus() {
+    if (!mStatusPending.load(std::memory_order_acquire))
+      return;
+    if (mStatus.controlModeChanged)
+      printf("CONTROL MODE = %d\n", mStatus.controlMode);
+    if (mStatus.parametersRequested)
+      SimpleVoice::printParameters(mStatus.parameters);
+    mStatusPending.store(false, std::memory_order_release);
+  }
+
  private:
   enum ControlMode {
     kPrintParameters = 5,
     kTone = 50,
     kFilterEnv = 51,
-    kAmpEnv = 52
+    kAmpEnv = 52,
+    kUnison = 53
   };
 
   enum ControlSource {
@@ -85,6 +269,168 @@ class Synthesizer {
     kKnobOrange = 4,
   };
 
+  // Any time in the past means "at the next frame rendered".
+  static constexpr int64_t kImmediately = 0;
+  // mLastPitch before the first note.
+  static constexpr int32_t kNoPitch = -1;
+
+  // Immediate events get their own queue so that they do not wait behind a
+  // scheduled event that is not due yet.
+  bool postEvent(int64_t frameTime, SynthEvent::Type type, uint8_t data1,
+                 uint8_t data2) {
+    SynthEvent event;
+    event.frameTime = frameTime;
+    event.type = type;
+    event.data1 = data1;
+    event.data2 = data2;
+    if (frameTime == kImmediately)
+      return mImmediateEvents.push(event);
+    return mScheduledEvents.push(event);
+  }
+
+  void applyDueEvents() {
+    SynthEvent event;
+    while (mImmediateEvents.peek(&event)) {
+      handleEvent(event);
+      mImmediateEvents.pop();
+    }
+    while (mScheduledEvents.peek(&event) && event.frameTime <= mFrameTime) {
+      handleEvent(event);
+      mScheduledEvents.pop();
+    }
+  }
+
+  int32_t getFramesUntilNextEvent(int32_t maxFrames) {
+    SynthEvent event;
+    if (mImmediateEvents.peek(&event))
+      return 0;
+    if (mScheduledEvents.peek(&event)
+        && event.frameTime - mFrameTime < maxFrames)
+      return static_cast<int32_t>(event.frameTime - mFrameTime);
+    return maxFrames;
+  }
+
+  void handleEvent(const SynthEvent& event) {
+    switch (event.type) {
+      case SynthEvent::kNoteOn:
+        handleNoteOn(event.data1);
+        break;
+      case SynthEvent::kNoteOff:
+        handleNoteOff(event.data1);
+        break;
+      case SynthEvent::kControlChange:
+        setControlMode(static_cast<ControlMode>(event.data1), event.data2);
+        routeControlChange(event.data1, event.data2);
+        break;
+      case SynthEvent::kFilterCutoff: {
+        synth_float_t cutoff =
+            SynthTools::interpolateMIDIValue(event.data1, 0, 8000.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterCutoff(cutoff); });
+        break;
+      }
+    }
+  }
+
+  // Pitches above 127 are ignored. Every note glides from the pitch of the
+  // note before it, see SimpleVoice::setGlideFactor().
+  void handleNoteOn(uint8_t pitch) {
+    bool stolen = false;
+    int32_t index = mVoices.noteOn(pitch, &stolen);
+    if (index == VoiceAllocator<SimpleVoice>::kNoVoice)
+      return;
+    SimpleVoice& voice = mVoices.getVoice(index);
+    synth_float_t glideFromPitch = static_cast<synth_float_t>(
+        (mLastPitch == kNoPitch) ? pitch : mLastPitch);
+    if (stolen) {
+      voice.steal(static_cast<synth_float_t>(pitch), glideFromPitch);
+    } else {
+      voice.setPitch(static_cast<synth_float_t>(pitch));
+      voice.start();
+      voice.glideFrom(glideFromPitch);
+    }
+    mLastPitch = pitch;
+  }
+
+  void handleNoteOff(uint8_t pitch) {
+    int32_t index = mVoices.noteOff(pitch);
+    if (index != VoiceAllocator<SimpleVoice>::kNoVoice)
+      mVoices.getVoice(index).stop();
+  }
+
+  /**
+   * Synthesize one block. The block is split wherever an event is due so
+   * that every event takes effect on its exact frame.
+   */
+  void renderBlock(synth_float_t* mix) {
+    const int32_t framesPerBlock = mContext.getFramesPerBlock();
+    int32_t framesDone = 0;
+    while (framesDone < framesPerBlock) {
+      applyDueEvents();
+      int32_t numFrames =
+          getFramesUntilNextEvent(framesPerBlock - framesDone);
+      // An event may have arrived since applyDueEvents() looked.
+      if (numFrames <= 0)
+        continue;
+      renderVoices(mix + framesDone, numFrames);
+      framesDone += numFrames;
+      mFrameTime += numFrames;
+    }
+  }
+
+  // Sum every active voice into the mix and recycle the ones that went silent.
+  void renderVoices(synth_float_t* mix, int32_t numFrames) {
+    memset(mix, 0, numFrames * sizeof(synth_float_t));
+#if SYNTHMARK_HAS_THREADS
+    if (mRenderPool && mVoices.getActiveCount() > 1) {
+      renderVoicesInParallel(mix, numFrames);
+      return;
+    }
+#endif
+    // Walk backwards because release() moves the last active voice into the
+    // slot being released.
+    for (int32_t n = mVoices.getActiveCount() - 1; n >= 0; n--) {
+      int32_t index = mVoices.getActiveVoice(n);
+      SimpleVoice& voice = mVoices.getVoice(index);
+      voice.generate(numFrames, &mScratch);
+      SynthTools::addBuffers(voice.output, 1.0, mix, numFrames);
+      if (!voice.isActive())
+        mVoices.release(index);
+    }
+  }
+
+#if SYNTHMARK_HAS_THREADS
+  // Generate the voices on the pool, then mix and release them on this
+  // thread in the same order as the loop above so that the sums round the
+  // same way.
+  void renderVoicesInParallel(synth_float_t* mix, int32_t numFrames) {
+    const int32_t numActive = mVoices.getActiveCount();
+    for (int32_t n = 0; n < numActive; n++)
+      mRenderOrder[n] = mVoices.getActiveVoice(numActive - 1 - n);
+
+    auto generateVoice = [this, numFrames](int32_t task,
+                                           VoiceScratch* scratch) {
+      mVoices.getVoice(mRenderOrder[task]).generate(numFrames, scratch);
+    };
+    mRenderPool->run(numActive, generateVoice);
+
+    for (int32_t n = 0; n < numActive; n++) {
+      int32_t index = mRenderOrder[n];
+      SimpleVoice& voice = mVoices.getVoice(index);
+      SynthTools::addBuffers(voice.output, 1.0, mix, numFrames);
+      if (!voice.isActive())
+        mVoices.release(index);
+    }
+  }
+#endif
+
+  // Patch parameters are shared, so every voice in the pool gets the change.
+  template <typename Function>
+  void forEachVoice(Function function) {
+    for (int32_t i = 0; i < mVoices.getMaxVoices(); i++)
+      function(mVoices.getVoice(i));
+  }
+
   void setControlMode(ControlMode controlMode, uint8_t value) {
     if (value != 127)
       return;
@@ -92,15 +438,32 @@ class Synthesizer {
       case ControlMode::kTone:
       case ControlMode::kFilterEnv:
       case ControlMode::kAmpEnv:
+      case ControlMode::kUnison:
         mControlMode = controlMode;
-        printf("CONTROL MODE = %d\n", controlMode);
+        if (canPostStatus()) {
+          mStatus = Status();
+          mStatus.controlModeChanged = true;
+          mStatus.controlMode = controlMode;
+          mStatusPending.store(true, std::memory_order_release);
+        }
         break;
       case ControlMode::kPrintParameters:
-        mVoice->printParameters();
+        if (canPostStatus()) {
+          mStatus = Status();
+          mStatus.parametersRequested = true;
+          mStatus.parameters = mVoices.getVoice(0).getParameters();
+          mStatusPending.store(true, std::memory_order_release);
+        }
         break;
     }
   }
 
+  // The render thread owns mStatus while no status is pending. A request
+  // made before printStatus() consumed the previous one is dropped.
+  bool canPostStatus() const {
+    return !mStatusPending.load(std::memory_order_acquire);
+  }
+
   void routeControlChange(uint8_t control, uint8_t value) {
     switch (mControlMode) {
       case ControlMode::kTone:
@@ -112,6 +475,9 @@ class Synthesizer {
       case ControlMode::kAmpEnv:
         controlAmpEnv(control, value);
         break;
+      case ControlMode::kUnison:
+        controlUnison(control, value);
+        break;
       default:
         break;
     }
@@ -119,71 +485,153 @@ class Synthesizer {
 
   void controlTone(uint8_t control, uint8_t value) {
     switch (control) {
-      case ControlSource::kKnobBlue:
-        mVoice->setGlideFactor(
-            SynthTools::interpolateMIDIValue(value, 0.00001, 0.01));
+      case ControlSource::kKnobBlue: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.00001, 0.01);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setGlideFactor(setting); });
         break;
+      }
       case ControlSource::kKnobGreen: {
-        mVoice->setFilterCutoff(
-            SynthTools::interpolateMIDIValue(value, 0, 8000.0));
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0, 8000.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterCutoff(setting); });
         break;
       }
-      case ControlSource::kKnobWhite:
-        mVoice->setFilterQ(
-            SynthTools::interpolateMIDIValue(value, 0.01, 10.0));
+      case ControlSource::kKnobWhite: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.01, 10.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterQ(setting); });
         break;
-      case ControlSource::kKnobOrange:
-        mVoice->setFilterEnvDepth(
-            SynthTools::interpolateMIDIValue(value, 1000.0, 5000.0));
+      }
+      case ControlSource::kKnobOrange: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 1000.0, 5000.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterEnvDepth(setting); });
         break;
+      }
     }
   }
 
   void controlFilterEnv(uint8_t control, uint8_t value) {
     switch (control) {
-      case ControlSource::kKnobBlue:
-        mVoice->setFilterAttack(
-            SynthTools::interpolateMIDIValue(value, 0.001, 2.0));
+      case ControlSource::kKnobBlue: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 2.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterAttack(setting); });
         break;
-      case ControlSource::kKnobGreen:
-        mVoice->setFilterDecay(
-            SynthTools::interpolateMIDIValue(value, 0.001, 1.0));
+      }
+      case ControlSource::kKnobGreen: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 1.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterDecay(setting); });
         break;
-      case ControlSource::kKnobWhite:
-        mVoice->setFilterSustain(
-            SynthTools::interpolateMIDIValue(value, 0.0001, 1.0));
+      }
+      case ControlSource::kKnobWhite: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.0001, 1.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterSustain(setting); });
         break;
-      case ControlSource::kKnobOrange:
-        mVoice->setFilterRelease(
-            SynthTools::interpolateMIDIValue(value, 0.001, 2.0));
+      }
+      case ControlSource::kKnobOrange: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 2.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setFilterRelease(setting); });
         break;
+      }
     }
   }
 
   void controlAmpEnv(uint8_t control, uint8_t value) {
     switch (control) {
-      case ControlSource::kKnobBlue:
-        mVoice->setAmpAttack(
-            SynthTools::interpolateMIDIValue(value, 0.001, 2.0));
+      case ControlSource::kKnobBlue: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 2.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setAmpAttack(setting); });
         break;
-      case ControlSource::kKnobGreen:
-        mVoice->setAmpDecay(
-            SynthTools::interpolateMIDIValue(value, 0.001, 1.0));
+      }
+      case ControlSource::kKnobGreen: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 1.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setAmpDecay(setting); });
+        break;
+      }
+      case ControlSource::kKnobWhite: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.0001, 1.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setAmpSustain(setting); });
         break;
-      case ControlSource::kKnobWhite:
-        mVoice->setAmpSustain(
-            SynthTools::interpolateMIDIValue(value, 0.0001, 1.0));
+      }
+      case ControlSource::kKnobOrange: {
+        synth_float_t setting =
+            SynthTools::interpolateMIDIValue(value, 0.001, 2.0);
+        forEachVoice(
+            [=](SimpleVoice& voice) { voice.setAmpRelease(setting); });
         break;
-      case ControlSource::kKnobOrange:
-        mVoice->setAmpRelease(
-            SynthTools::interpolateMIDIValue(value, 0.001, 2.0));
+      }
+    }
+  }
+
+  void controlUnison(uint8_t control, uint8_t value) {
+    SimpleVoice::Parameters parameters = mVoices.getVoice(0).getParameters();
+    int32_t count = parameters.unisonCount;
+    synth_float_t spread = parameters.unisonSpread;
+    switch (control) {
+      case ControlSource::kKnobBlue:
+        count = static_cast<int32_t>(lroundf(SynthTools::interpolateMIDIValue(
+            value, 1.0, SUPERSAW_MAX_OSCILLATORS)));
+        break;
+      case ControlSource::kKnobGreen:
+        spread = SynthTools::interpolateMIDIValue(value, 0.0, 1.0);
         break;
+      default:
+        return;
     }
+    forEachVoice(
+        [=](SimpleVoice& voice) { voice.setUnison(count, spread); });
   }
 
-  SimpleVoice* mVoice = nullptr;
-  std::vector<synth_float_t> mPitches;
+  // Declared before mVoices so it exists when the voices are attached.
+  EngineContext mContext;
+  VoiceAllocator<SimpleVoice> mVoices;
+  // Frames of the last block that have not been rendered out yet.
+  synth_float_t mMixBuffer[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+  int32_t mMixFrames = 0;
+  int32_t mMixReadIndex = 0;
+  // Number of frames synthesized so far.
+  int64_t mFrameTime = 0;
+  SynthEventQueue mImmediateEvents;
+  SynthEventQueue mScheduledEvents;
   ControlMode mControlMode = ControlMode::kTone;
+  // Pitch of the last note started, where the next note glides from.
+  int32_t mLastPitch = kNoPitch;
+  // Scratch for voices rendered on the calling thread.
+  VoiceScratch mScratch;
+  // Voice indices of the current block in mixing order.
+  std::vector<int32_t> mRenderOrder;
+#if SYNTHMARK_HAS_THREADS
+  std::unique_ptr<VoiceRenderPool> mRenderPool;
+#endif
+
+  // Messages for printStatus(), handed over through mStatusPending.
+  struct Status {
+    bool controlModeChanged = false;
+    ControlMode controlMode = ControlMode::kTone;
+    bool parametersRequested = false;
+    SimpleVoice::Parameters parameters = {};
+  };
+  Status mStatus;
+  std::atomic<bool> mStatusPending{false};
 };
 
 #endif // SYNTHMARK_SYNTHESIZER_H
@@ -16,5 +16,4 @@
 
 #include "UnitGenerator.h"
 
-int32_t UnitGenerator::mSampleRate = SYNTHMARK_SAMPLE_RATE;
-synth_float_t UnitGenerator::mSamplePeriod = 1.0f / SYNTHMARK_SAMPLE_RATE;
+EngineContext UnitGenerator::sDefaultContext(SYNTHMARK_SAMPLE_RATE);
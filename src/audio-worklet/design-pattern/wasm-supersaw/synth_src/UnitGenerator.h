@@ -26,6 +26,8 @@
 #include <math.h>
 #include "SynthMark.h"
 #include "DifferentiatedParabola.h"
+#include "EngineContext.h"
+#include "DenormalGuard.h"
 
 class UnitGenerator
 {
@@ -34,21 +36,52 @@ public:
 
     virtual ~UnitGenerator() = default;
 
-    static void setSampleRate(int32_t sampleRate) {
-        assert(sampleRate > 0);
-        mSampleRate = sampleRate;
-        mSamplePeriod = 1.0f / sampleRate;
+    /**
+     * Attach this generator to the engine that runs it. Generators that
+     * contain other generators must forward the context to them.
+     * Until this is called a shared default context at
+     * SYNTHMARK_SAMPLE_RATE is used.
+     */
+    virtual void setEngineContext(EngineContext *context) {
+        assert(context != nullptr);
+        mContext = context;
     }
 
-    static int32_t getSampleRate() {
-        return mSampleRate;
+    EngineContext *getEngineContext() const {
+        return mContext;
     }
 
-    synth_float_t output[SYNTHMARK_FRAMES_PER_RENDER];
+    int32_t getSampleRate() const {
+        return mContext->getSampleRate();
+    }
 
-public:
-    static int32_t mSampleRate;
-    static synth_float_t mSamplePeriod;
+    synth_float_t getSamplePeriod() const {
+        return mContext->getSamplePeriod();
+    }
+
+    /**
+     * Count denormal, NaN and infinite samples in the output of every
+     * generate() from now on. Pass nullptr to stop counting.
+     */
+    void setSampleCounters(SampleCounters *counters) {
+        mSampleCounters = counters;
+    }
+
+    synth_float_t output[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+
+protected:
+    // Generators call this at the end of generate().
+    void countOutput(int32_t numSamples) {
+        if (mSampleCounters != nullptr) {
+            mSampleCounters->count(output, numSamples);
+        }
+    }
+
+    EngineContext *mContext = &sDefaultContext;
+
+private:
+    static EngineContext sDefaultContext;
+    SampleCounters *mSampleCounters = nullptr;
 };
 
 #endif // SYNTHMARK_UNIT_GENERATOR_H
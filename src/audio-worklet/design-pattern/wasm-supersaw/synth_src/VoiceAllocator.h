@@ -0,0 +1,219 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_VOICE_ALLOCATOR_H
+#define SYNTHMARK_VOICE_ALLOCATOR_H
+
+#include <cstdint>
+#include "SynthMark.h"
+
+#define SYNTHMARK_NUM_PITCHES  128
+
+/**
+ * Fixed size pool of voices with note-to-voice bookkeeping.
+ *
+ * All storage is allocated in the constructor. noteOn(), noteOff() and
+ * release() only move indices between a free stack and an active list, so
+ * they are safe to call from the audio thread.
+ *
+ * VoiceType must provide:
+ *   bool isReleased()           - gate is off and the voice is fading away
+ *   synth_float_t getAmplitude() - current amplitude envelope level
+ */
+template <typename VoiceType>
+class VoiceAllocator
+{
+public:
+    static constexpr int32_t kNoVoice = -1;
+
+    explicit VoiceAllocator(int32_t maxVoices)
+        : mMaxVoices(clampVoiceCount(maxVoices)) {
+        mVoices = new VoiceType[mMaxVoices];
+        mFreeStack = new int32_t[mMaxVoices];
+        mActiveList = new int32_t[mMaxVoices];
+        mActiveSlot = new int32_t[mMaxVoices];
+        mPitchOfVoice = new int32_t[mMaxVoices];
+        mStartSerial = new uint32_t[mMaxVoices];
+        for (int32_t i = 0; i < mMaxVoices; i++) {
+            // Push in reverse so voice 0 is handed out first.
+            mFreeStack[i] = mMaxVoices - 1 - i;
+            mActiveSlot[i] = kNoVoice;
+            mPitchOfVoice[i] = kNoVoice;
+            mStartSerial[i] = 0;
+        }
+        mNumFree = mMaxVoices;
+        for (int32_t i = 0; i < SYNTHMARK_NUM_PITCHES; i++) {
+            mVoiceForPitch[i] = kNoVoice;
+        }
+    }
+
+    virtual ~VoiceAllocator() {
+        delete[] mVoices;
+        delete[] mFreeStack;
+        delete[] mActiveList;
+        delete[] mActiveSlot;
+        delete[] mPitchOfVoice;
+        delete[] mStartSerial;
+    }
+
+    /**
+     * Assign a voice to the pitch.
+     *
+     * @param stolen set to true when the returned voice was already sounding
+     *     and must fade out before playing the new pitch
+     * @return index of the voice to start, or kNoVoice if the pitch is not
+     *     a MIDI pitch from 0 to 127
+     */
+    int32_t noteOn(uint8_t pitch, bool *stolen) {
+        *stolen = false;
+        if (pitch >= SYNTHMARK_NUM_PITCHES) {
+            return kNoVoice;
+        }
+        int32_t index = mVoiceForPitch[pitch];
+        if (index != kNoVoice) {
+            // Retrigger the voice that is already playing this pitch.
+        } else if (mNumFree > 0) {
+            index = mFreeStack[--mNumFree];
+            addActive(index);
+        } else {
+            index = findVoiceToSteal();
+            unmapPitch(index);
+            *stolen = true;
+        }
+        mVoiceForPitch[pitch] = index;
+        mPitchOfVoice[index] = pitch;
+        mStartSerial[index] = mNextSerial++;
+        return index;
+    }
+
+    /**
+     * @return index of the voice playing the pitch or kNoVoice
+     */
+    int32_t noteOff(uint8_t pitch) {
+        if (pitch >= SYNTHMARK_NUM_PITCHES) {
+            return kNoVoice;
+        }
+        int32_t index = mVoiceForPitch[pitch];
+        mVoiceForPitch[pitch] = kNoVoice;
+        if (index != kNoVoice) {
+            mPitchOfVoice[index] = kNoVoice;
+        }
+        return index;
+    }
+
+    /**
+     * Return a silent voice to the free stack.
+     */
+    void release(int32_t index) {
+        if (mActiveSlot[index] == kNoVoice) {
+            return;
+        }
+        unmapPitch(index);
+        removeActive(index);
+        mFreeStack[mNumFree++] = index;
+    }
+
+    VoiceType &getVoice(int32_t index) {
+        return mVoices[index];
+    }
+
+    int32_t getMaxVoices() const {
+        return mMaxVoices;
+    }
+
+    int32_t getActiveCount() const {
+        return mNumActive;
+    }
+
+    /**
+     * @return index of the n-th active voice, 0 <= n < getActiveCount()
+     */
+    int32_t getActiveVoice(int32_t n) const {
+        return mActiveList[n];
+    }
+
+private:
+    static int32_t clampVoiceCount(int32_t maxVoices) {
+        if (maxVoices < 1) return 1;
+        if (maxVoices > SYNTHMARK_MAX_VOICES) return SYNTHMARK_MAX_VOICES;
+        return maxVoices;
+    }
+
+    void addActive(int32_t index) {
+        mActiveSlot[index] = mNumActive;
+        mActiveList[mNumActive++] = index;
+    }
+
+    // Swap with the last entry so removal is O(1).
+    void removeActive(int32_t index) {
+        int32_t slot = mActiveSlot[index];
+        int32_t last = mActiveList[--mNumActive];
+        mActiveList[slot] = last;
+        mActiveSlot[last] = slot;
+        mActiveSlot[index] = kNoVoice;
+    }
+
+    void unmapPitch(int32_t index) {
+        int32_t pitch = mPitchOfVoice[index];
+        if (pitch != kNoVoice && mVoiceForPitch[pitch] == index) {
+            mVoiceForPitch[pitch] = kNoVoice;
+        }
+        mPitchOfVoice[index] = kNoVoice;
+    }
+
+    /**
+     * Prefer the quietest voice that has already been released. If every
+     * voice is still held then take the oldest one.
+     */
+    int32_t findVoiceToSteal() {
+        int32_t quietest = kNoVoice;
+        synth_float_t quietestLevel = 0;
+        int32_t oldest = mActiveList[0];
+        for (int32_t n = 0; n < mNumActive; n++) {
+            int32_t index = mActiveList[n];
+            VoiceType &voice = mVoices[index];
+            if (voice.isReleased()) {
+                synth_float_t level = voice.getAmplitude();
+                if (quietest == kNoVoice || level < quietestLevel) {
+                    quietest = index;
+                    quietestLevel = level;
+                }
+            }
+            // Unsigned difference handles wraparound of the serial counter.
+            if ((int32_t) (mStartSerial[index] - mStartSerial[oldest]) < 0) {
+                oldest = index;
+            }
+        }
+        return (quietest != kNoVoice) ? quietest : oldest;
+    }
+
+    const int32_t mMaxVoices;
+    VoiceType *mVoices = nullptr;
+
+    int32_t *mFreeStack = nullptr;
+    int32_t mNumFree = 0;
+
+    int32_t *mActiveList = nullptr;
+    int32_t *mActiveSlot = nullptr;
+    int32_t mNumActive = 0;
+
+    int32_t *mPitchOfVoice = nullptr;
+    uint32_t *mStartSerial = nullptr;
+    uint32_t mNextSerial = 0;
+    int32_t mVoiceForPitch[SYNTHMARK_NUM_PITCHES];
+};
+
+#endif // SYNTHMARK_VOICE_ALLOCATOR_H
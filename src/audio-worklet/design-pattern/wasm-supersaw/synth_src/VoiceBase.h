@@ -22,6 +22,15 @@
 #include "UnitGenerator.h"
 #include "ChannelContext.h"
 
+/**
+ * Temporary buffers used while a voice generates one block. Nothing is kept
+ * between blocks, so each rendering thread owns one and lends it to every
+ * voice it renders instead of every voice carrying its own.
+ */
+struct VoiceScratch {
+    synth_float_t buffer1[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+};
+
 /**
  * Base class for building synthesizers.
  */
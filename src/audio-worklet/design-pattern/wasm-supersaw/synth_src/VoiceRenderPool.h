@@ -0,0 +1,274 @@
+/*
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHMARK_VOICE_RENDER_POOL_H
+#define SYNTHMARK_VOICE_RENDER_POOL_H
+
+#include <cstdint>
+#include "SynthMark.h"
+#include "VoiceBase.h"
+#include "DenormalGuard.h"
+
+// Threads are available natively and in wasm builds made with -pthread.
+#ifndef SYNTHMARK_HAS_THREADS
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define SYNTHMARK_HAS_THREADS  0
+#else
+#define SYNTHMARK_HAS_THREADS  1
+#endif
+#endif
+
+// Upper limit for VoiceRenderPool, including the calling thread.
+#define SYNTHMARK_MAX_RENDER_THREADS  16
+
+#if SYNTHMARK_HAS_THREADS
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work stealing thread pool that runs the voices of one block in parallel.
+ *
+ * run() hands out task indices and returns when every task has finished.
+ * The calling thread works on tasks too, so a pool of N threads starts N - 1
+ * workers. The tasks are split evenly between the threads up front. A thread
+ * that runs out of tasks steals from the far end of another thread's share.
+ *
+ * The caller does not wait for workers to wake up. If they are slow, the
+ * caller steals the unclaimed tasks and runs the block by itself. It does
+ * wait, spinning with yield(), for tasks that a worker has already claimed.
+ * A task advances the state of its voice, so the caller cannot simply run
+ * it a second time. If a worker is preempted in the middle of a task, the
+ * block therefore takes until the scheduler runs that worker again, which
+ * can be a whole time slice. Give the workers a real-time priority where
+ * the platform allows it, or use one thread if the audio callback must not
+ * depend on the scheduling of other threads.
+ *
+ * Each thread has its own VoiceScratch, which is passed to every task that
+ * the thread runs.
+ */
+class VoiceRenderPool
+{
+public:
+    explicit VoiceRenderPool(int32_t numThreads)
+        : mNumThreads(clampThreadCount(numThreads)) {
+        mScratch = new ThreadScratch[mNumThreads];
+        for (int32_t i = 1; i < mNumThreads; i++) {
+            mWorkers.emplace_back(&VoiceRenderPool::workerLoop, this, i);
+        }
+    }
+
+    VoiceRenderPool(const VoiceRenderPool &) = delete;
+    VoiceRenderPool &operator=(const VoiceRenderPool &) = delete;
+
+    ~VoiceRenderPool() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping.store(true, std::memory_order_relaxed);
+            mGeneration.fetch_add(1, std::memory_order_release);
+        }
+        mWakeUp.notify_all();
+        for (std::thread &worker : mWorkers) {
+            worker.join();
+        }
+        delete[] mScratch;
+    }
+
+    int32_t getNumThreads() const {
+        return mNumThreads;
+    }
+
+    /**
+     * Call task(taskIndex, scratch) once for every index in [0, numTasks)
+     * and wait for all of them. Tasks run in any order on any thread.
+     * Does not allocate or lock, so it may be called from the audio thread.
+     */
+    template <typename Task>
+    void run(int32_t numTasks, Task &task) {
+        if (numTasks <= 0) {
+            return;
+        }
+        mTaskContext = &task;
+        mInvokeTask = [](void *context, int32_t taskIndex,
+                         VoiceScratch *scratch) {
+            (*static_cast<Task *>(context))(taskIndex, scratch);
+        };
+        mTasksRemaining.store(numTasks, std::memory_order_relaxed);
+        // Give each thread a contiguous share. Publishing a share also
+        // publishes the task above to whoever claims from it.
+        for (int32_t i = 0; i < mNumThreads; i++) {
+            int32_t begin = numTasks * i / mNumThreads;
+            int32_t end = numTasks * (i + 1) / mNumThreads;
+            mScratch[i].range.store(packRange(begin, end),
+                                    std::memory_order_release);
+        }
+        mGeneration.fetch_add(1, std::memory_order_release);
+        if (mNumSleeping.load(std::memory_order_acquire) > 0) {
+            mWakeUp.notify_all();
+        }
+
+        runTasks(0);
+        // Only tasks that a worker is running are left, see above.
+        while (mTasksRemaining.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    // Number of times an idle worker polls for work before it sleeps.
+    static constexpr int32_t kIdleSpins = 2000;
+    // A sleeping worker polls at this period in case it missed a wake up.
+    static constexpr int32_t kSleepMicros = 1000;
+
+    // One cache line per thread so that claiming does not cause false
+    // sharing with the other threads.
+    struct alignas(64) ThreadScratch {
+        // Unclaimed tasks, begin in the high half and end in the low half.
+        std::atomic<uint64_t> range{0};
+        VoiceScratch scratch;
+    };
+
+    static int32_t clampThreadCount(int32_t numThreads) {
+        if (numThreads < 1) return 1;
+        if (numThreads > SYNTHMARK_MAX_RENDER_THREADS) {
+            return SYNTHMARK_MAX_RENDER_THREADS;
+        }
+        return numThreads;
+    }
+
+    static uint64_t packRange(int32_t begin, int32_t end) {
+        return (static_cast<uint64_t>(begin) << 32) | static_cast<uint32_t>(end);
+    }
+
+    static int32_t rangeBegin(uint64_t range) {
+        return static_cast<int32_t>(range >> 32);
+    }
+
+    static int32_t rangeEnd(uint64_t range) {
+        return static_cast<int32_t>(range & 0xFFFFFFFF);
+    }
+
+    // The owner takes tasks from the front of its share.
+    bool claimOwn(int32_t thread, int32_t *taskIndex) {
+        std::atomic<uint64_t> &range = mScratch[thread].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        while (rangeBegin(current) < rangeEnd(current)) {
+            uint64_t next = packRange(rangeBegin(current) + 1,
+                                      rangeEnd(current));
+            if (range.compare_exchange_weak(current, next,
+                                            std::memory_order_acquire)) {
+                *taskIndex = rangeBegin(current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Thieves take tasks from the back so they rarely collide with the owner.
+    bool steal(int32_t victim, int32_t *taskIndex) {
+        std::atomic<uint64_t> &range = mScratch[victim].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        while (rangeBegin(current) < rangeEnd(current)) {
+            uint64_t next = packRange(rangeBegin(current),
+                                      rangeEnd(current) - 1);
+            if (range.compare_exchange_weak(current, next,
+                                            std::memory_order_acquire)) {
+                *taskIndex = rangeEnd(current) - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool claim(int32_t thread, int32_t *taskIndex) {
+        if (claimOwn(thread, taskIndex)) {
+            return true;
+        }
+        for (int32_t i = 1; i < mNumThreads; i++) {
+            if (steal((thread + i) % mNumThreads, taskIndex)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runTasks(int32_t thread) {
+        VoiceScratch *scratch = &mScratch[thread].scratch;
+        int32_t taskIndex;
+        while (claim(thread, &taskIndex)) {
+            // The claim synchronized with run(), so the task is current.
+            mInvokeTask(mTaskContext, taskIndex, scratch);
+            mTasksRemaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void workerLoop(int32_t thread) {
+        // Workers only render, so they flush denormals for their whole life.
+        ScopedDenormalGuard denormals;
+        uint32_t seenGeneration = 0;
+        while (true) {
+            seenGeneration = waitForGeneration(seenGeneration);
+            if (mStopping.load(std::memory_order_relaxed)) {
+                return;
+            }
+            runTasks(thread);
+        }
+    }
+
+    // Spin briefly so back to back blocks do not pay for a wake up, then
+    // sleep until run() or the destructor notifies.
+    uint32_t waitForGeneration(uint32_t seenGeneration) {
+        for (int32_t i = 0; i < kIdleSpins; i++) {
+            uint32_t generation = mGeneration.load(std::memory_order_acquire);
+            if (generation != seenGeneration) {
+                return generation;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNumSleeping.fetch_add(1, std::memory_order_acq_rel);
+        uint32_t generation;
+        while ((generation = mGeneration.load(std::memory_order_acquire))
+                == seenGeneration) {
+            mWakeUp.wait_for(lock, std::chrono::microseconds(kSleepMicros));
+        }
+        mNumSleeping.fetch_sub(1, std::memory_order_relaxed);
+        return generation;
+    }
+
+    const int32_t mNumThreads;
+    ThreadScratch *mScratch = nullptr;
+    std::vector<std::thread> mWorkers;
+
+    void *mTaskContext = nullptr;
+    void (*mInvokeTask)(void *context, int32_t taskIndex,
+                        VoiceScratch *scratch) = nullptr;
+    std::atomic<int32_t> mTasksRemaining{0};
+    std::atomic<uint32_t> mGeneration{0};
+
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::atomic<int32_t> mNumSleeping{0};
+    std::atomic<bool> mStopping{false};
+};
+
+#endif // SYNTHMARK_HAS_THREADS
+
+#endif // SYNTHMARK_VOICE_RENDER_POOL_H
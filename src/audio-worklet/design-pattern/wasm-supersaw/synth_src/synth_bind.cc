@@ -29,6 +29,20 @@ class SynthesizerWrapper : public Synthesizer {
     float* output_array = reinterpret_cast<float*>(output_ptr);
     Synthesizer::render(output_array, numFrames);
   }
+
+  // JavaScript numbers are doubles, so frame times are passed as doubles.
+  bool scheduleNoteOn(uint8_t pitch, double frameTime) {
+    return Synthesizer::scheduleNoteOn(pitch, static_cast<int64_t>(frameTime));
+  }
+
+  bool scheduleNoteOff(uint8_t pitch, double frameTime) {
+    return Synthesizer::scheduleNoteOff(pitch,
+                                        static_cast<int64_t>(frameTime));
+  }
+
+  double getFrameTime() const {
+    return static_cast<double>(Synthesizer::getFrameTime());
+  }
 };
 
 EMSCRIPTEN_BINDINGS(CLASS_Synthesizer) {
@@ -36,10 +50,17 @@ EMSCRIPTEN_BINDINGS(CLASS_Synthesizer) {
   class_<Synthesizer>("SynthesizerBase")
       .constructor<int32_t>()
       .function("noteOff", &Synthesizer::noteOff)
-      .function("noteOn", &Synthesizer::noteOn);
+      .function("noteOn", &Synthesizer::noteOn)
+      .function("controlChange", &Synthesizer::controlChange)
+      .function("setFramesPerBlock", &Synthesizer::setFramesPerBlock)
+      .function("setRenderThreads", &Synthesizer::setRenderThreads)
+      .function("printStatus", &Synthesizer::printStatus);
 
   // Then expose the overridden `render` method from the wrapper class.
   class_<SynthesizerWrapper, base<Synthesizer>>("Synthesizer")
       .constructor<int32_t>()
-      .function("render", &SynthesizerWrapper::render, allow_raw_pointers());
+      .function("render", &SynthesizerWrapper::render, allow_raw_pointers())
+      .function("scheduleNoteOn", &SynthesizerWrapper::scheduleNoteOn)
+      .function("scheduleNoteOff", &SynthesizerWrapper::scheduleNoteOff)
+      .function("getFrameTime", &SynthesizerWrapper::getFrameTime);
 }
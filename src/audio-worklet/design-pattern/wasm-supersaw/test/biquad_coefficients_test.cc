@@ -0,0 +1,160 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that BiquadFilter follows a moving cutoff closely with the
+// tabulated and interpolated coefficients, and that it recalculates cached
+// coefficients when a fixed cutoff changes.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "BiquadCoefficients.h"
+#include "BiquadFilter.h"
+#include "SawtoothOscillator.h"
+#include "SawtoothOscillatorDPW.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kFramesPerBlock = 128;
+constexpr int32_t kNumBlocks = 100;
+constexpr synth_float_t kQ = 3.0f;
+
+// Same lowpass as BiquadCoefficients::setLowpass(), calculated directly in
+// double precision.
+BiquadCoefficients CalculateExactLowpass(double frequency) {
+  double omega = 2.0 * M_PI * frequency / kTestSampleRate;
+  double alpha = sin(omega) / (2.0 * kQ);
+  double scalar = 1.0 / (1.0 + alpha);
+  double omc = 1.0 - cos(omega);
+  BiquadCoefficients c;
+  c.a0 = static_cast<synth_float_t>(omc * 0.5 * scalar);
+  c.a1 = static_cast<synth_float_t>(omc * scalar);
+  c.a2 = c.a0;
+  c.b1 = static_cast<synth_float_t>(-2.0 * cos(omega) * scalar);
+  c.b2 = static_cast<synth_float_t>((1.0 - alpha) * scalar);
+  return c;
+}
+
+// Direct form biquad that calculates the coefficients for every sample.
+class ExactFilter {
+ public:
+  explicit ExactFilter(bool use_table) : use_table_(use_table) {}
+
+  synth_float_t Process(synth_float_t frequency, synth_float_t xn) {
+    BiquadCoefficients c;
+    if (use_table_)
+      c.setLowpass(frequency * (1.0f / kTestSampleRate), kQ);
+    else
+      c = CalculateExactLowpass(frequency);
+    synth_float_t finite = (c.a0 * xn) + (c.a1 * xn1_) + (c.a2 * xn2_);
+    synth_float_t yn = finite - (c.b1 * yn1_) - (c.b2 * yn2_);
+    xn2_ = xn1_;
+    xn1_ = xn;
+    yn2_ = yn1_;
+    yn1_ = yn;
+    return yn;
+  }
+
+ private:
+  bool use_table_;
+  synth_float_t xn1_ = 0;
+  synth_float_t xn2_ = 0;
+  double yn1_ = 0;
+  double yn2_ = 0;
+};
+
+// Exponential sweeps up and down, like a filter envelope.
+synth_float_t GetSweptCutoff(int32_t frame) {
+  double position = fmod(frame / 4800.0, 2.0);
+  double octaves = position < 1.0 ? position * 7.0 : (2.0 - position) * 7.0;
+  return static_cast<synth_float_t>(60.0 * pow(2.0, octaves));
+}
+
+int TestSweepFollowsExactCoefficients() {
+  EngineContext context(kTestSampleRate);
+  SawtoothOscillatorDPW saw;
+  BiquadFilter filter;
+  ExactFilter exact(false);
+  saw.setEngineContext(&context);
+  filter.setEngineContext(&context);
+  filter.setQ(kQ);
+
+  synth_float_t max_error = 0;
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    saw.generate(220.0f, kFramesPerBlock);
+    synth_float_t cutoff[kFramesPerBlock];
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      cutoff[i] = GetSweptCutoff(block * kFramesPerBlock + i);
+    filter.generate(saw.output, cutoff, kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++) {
+      synth_float_t expected = exact.Process(cutoff[i], saw.output[i]);
+      max_error = fmaxf(max_error, fabsf(expected - filter.output[i]));
+    }
+  }
+  if (max_error > 2.0e-3f) {
+    printf("FAIL swept cutoff, max error = %g\n", max_error);
+    return 1;
+  }
+  return 0;
+}
+
+int TestFixedCutoffIsExact() {
+  EngineContext context(kTestSampleRate);
+  SawtoothOscillatorDPW saw;
+  BiquadFilter filter;
+  ExactFilter exact(true);
+  saw.setEngineContext(&context);
+  filter.setEngineContext(&context);
+  filter.setQ(kQ);
+
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    saw.generate(220.0f, kFramesPerBlock);
+    // Change the cutoff now and then to check that the cache notices.
+    const synth_float_t frequency = (block / 10 % 2 == 0) ? 800.0f : 3000.0f;
+    synth_float_t cutoff[kFramesPerBlock];
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      cutoff[i] = frequency;
+    filter.generate(saw.output, cutoff, kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++) {
+      // BiquadFilter nudges its feedback at the end of each block, so allow
+      // for that but nothing more.
+      synth_float_t expected = exact.Process(frequency, saw.output[i]);
+      if (fabsf(expected - filter.output[i]) > 1.0e-6f) {
+        printf("FAIL fixed cutoff %g differs in block %d\n", frequency,
+               block);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestSweepFollowsExactCoefficients();
+  failures += TestFixedCutoffIsExact();
+  printf("biquad_coefficients_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
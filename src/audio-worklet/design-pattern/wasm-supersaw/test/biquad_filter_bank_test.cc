@@ -0,0 +1,134 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks BiquadCascade and BiquadFilterBank against BiquadFilter.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "SynthMark.h"
+#include "BiquadFilter.h"
+#include "BiquadCascade.h"
+#include "BiquadFilterBank.h"
+#include "SawtoothOscillator.h"
+#include "SawtoothOscillatorDPW.h"
+
+namespace {
+
+constexpr int32_t kFramesPerBlock = 64;
+constexpr int32_t kNumBlocks = 200;
+// The bank runs the recursion in single precision.
+constexpr synth_float_t kBankTolerance = 1.0e-4f;
+
+// A cutoff that sweeps over the block, like the filter envelope does.
+synth_float_t GetCutoff(int32_t lane, int32_t block) {
+  return 200.0f * (lane + 1) + 30.0f * (block % 50);
+}
+
+synth_float_t GetQ(int32_t lane) {
+  return 0.5f + lane * 0.7f;
+}
+
+int TestCascadeMatchesTwoFilters() {
+  SawtoothOscillatorDPW saw;
+  BiquadFilter filter1;
+  BiquadFilter filter2;
+  BiquadCascade cascade;
+  filter1.setQ(4.0f);
+  filter2.setQ(4.0f);
+  cascade.setQ(4.0f);
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    saw.generate(110.0f, kFramesPerBlock);
+    synth_float_t cutoff[kFramesPerBlock];
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      cutoff[i] = GetCutoff(2, block);
+    filter1.generate(saw.output, cutoff, kFramesPerBlock);
+    filter2.generate(filter1.output, cutoff, kFramesPerBlock);
+    cascade.generate(saw.output, cutoff, kFramesPerBlock);
+    if (memcmp(filter2.output, cascade.output,
+               kFramesPerBlock * sizeof(synth_float_t)) != 0) {
+      printf("FAIL cascade differs from two filters in block %d\n", block);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestBank(bool cascade) {
+  constexpr int32_t kNumLanes = BiquadFilterBank::kNumLanes;
+  SawtoothOscillatorDPW saws[kNumLanes];
+  BiquadFilter stage1[kNumLanes];
+  BiquadFilter stage2[kNumLanes];
+  BiquadFilterBank bank;
+  for (int32_t lane = 0; lane < kNumLanes; lane++) {
+    stage1[lane].setQ(GetQ(lane));
+    stage2[lane].setQ(GetQ(lane));
+  }
+
+  synth_float_t max_error = 0;
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    synth_float_t interleaved[kFramesPerBlock * kNumLanes];
+    for (int32_t lane = 0; lane < kNumLanes; lane++) {
+      saws[lane].generate(55.0f * (lane + 1), kFramesPerBlock);
+      BiquadFilterBank::interleave(lane, saws[lane].output, interleaved,
+                                   kFramesPerBlock);
+      bank.setLowpass(lane, GetCutoff(lane, block), GetQ(lane));
+    }
+    if (cascade)
+      bank.generateCascade(interleaved, interleaved, kFramesPerBlock);
+    else
+      bank.generate(interleaved, interleaved, kFramesPerBlock);
+
+    for (int32_t lane = 0; lane < kNumLanes; lane++) {
+      synth_float_t cutoff[kFramesPerBlock];
+      for (int32_t i = 0; i < kFramesPerBlock; i++)
+        cutoff[i] = GetCutoff(lane, block);
+      stage1[lane].generate(saws[lane].output, cutoff, kFramesPerBlock);
+      const synth_float_t* expected = stage1[lane].output;
+      if (cascade) {
+        stage2[lane].generate(stage1[lane].output, cutoff, kFramesPerBlock);
+        expected = stage2[lane].output;
+      }
+      synth_float_t actual[kFramesPerBlock];
+      BiquadFilterBank::deinterleave(lane, interleaved, actual,
+                                     kFramesPerBlock);
+      for (int32_t i = 0; i < kFramesPerBlock; i++)
+        max_error = fmaxf(max_error, fabsf(expected[i] - actual[i]));
+    }
+  }
+  if (max_error > kBankTolerance) {
+    printf("FAIL bank %s, max error = %g\n", cascade ? "cascade" : "stage",
+           max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestCascadeMatchesTwoFilters();
+  failures += TestBank(false);
+  failures += TestBank(true);
+  printf("biquad_filter_bank_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks ControlBlock arithmetic, that SmoothedParameter follows the same
+// curve for any block size, and that the supersaw follows a moving
+// frequency.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "ControlBlock.h"
+#include "EngineContext.h"
+#include "SmoothedParameter.h"
+#include "SupersawOscillatorBank.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kNumFrames = 37;
+
+ControlBlock MakeBlock(ControlBlock::Mode mode, synth_float_t* samples,
+                       synth_float_t start) {
+  switch (mode) {
+    case ControlBlock::CONSTANT:
+      return ControlBlock::constant(start);
+    case ControlBlock::RAMP:
+      return ControlBlock::ramp(start, -0.25f);
+    case ControlBlock::AUDIO:
+    default:
+      for (int32_t i = 0; i < kNumFrames; i++)
+        samples[i] = start + static_cast<synth_float_t>((i * 7) % 5);
+      return ControlBlock::audio(samples);
+  }
+}
+
+int TestAddScaled() {
+  const ControlBlock::Mode modes[] = {
+      ControlBlock::CONSTANT, ControlBlock::RAMP, ControlBlock::AUDIO};
+  const synth_float_t gain = 3.5f;
+  for (ControlBlock::Mode mode1 : modes) {
+    for (ControlBlock::Mode mode2 : modes) {
+      synth_float_t samples1[kNumFrames];
+      synth_float_t samples2[kNumFrames];
+      synth_float_t buffer[kNumFrames];
+      ControlBlock block1 = MakeBlock(mode1, samples1, 100.0f);
+      ControlBlock block2 = MakeBlock(mode2, samples2, 2.0f);
+      ControlBlock sum = block1.addScaled(block2, gain, buffer, kNumFrames);
+      const bool mixed = (mode1 == ControlBlock::AUDIO
+                          || mode2 == ControlBlock::AUDIO);
+      const bool both_constant = (mode1 == ControlBlock::CONSTANT
+                                  && mode2 == ControlBlock::CONSTANT);
+      const ControlBlock::Mode expected_mode = mixed ? ControlBlock::AUDIO
+          : both_constant ? ControlBlock::CONSTANT : ControlBlock::RAMP;
+      if (sum.mode != expected_mode) {
+        printf("FAIL addScaled(%d, %d) has mode %d\n", mode1, mode2,
+               sum.mode);
+        return 1;
+      }
+      for (int32_t i = 0; i < kNumFrames; i++) {
+        synth_float_t expected =
+            block1.getValue(i) + (block2.getValue(i) * gain);
+        if (fabsf(sum.getValue(i) - expected) > 1.0e-4f) {
+          printf("FAIL addScaled(%d, %d) frame %d is %f, expected %f\n",
+                 mode1, mode2, i, sum.getValue(i), expected);
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+// The value at every block end must lie on the per sample exponential,
+// whatever the block sizes.
+int TestSmoothingIgnoresBlockSize() {
+  const synth_float_t retention = 0.999f;
+  const int32_t block_sizes[] = {1, 8, 13, 64, 128};
+  for (int32_t block_size : block_sizes) {
+    SmoothedParameter parameter(100.0f);
+    parameter.setRetention(retention);
+    parameter.setTarget(1000.0f);
+    int32_t frame = 0;
+    synth_float_t previous = 100.0f;
+    while (frame < 20000) {
+      ControlBlock block = parameter.next(block_size);
+      frame += block_size;
+      synth_float_t last = block.getValue(block_size - 1);
+      double exact = 1000.0 - 900.0 * pow(retention, frame);
+      if (fabs(last - exact) > 1.0e-4 * exact + 1.0e-2) {
+        printf("FAIL %d frame blocks: frame %d is %f, expected %f\n",
+               block_size, frame, last, exact);
+        return 1;
+      }
+      // Rising smoothly, without steps inside the block. Allow for the
+      // rounding of value + (i * increment).
+      for (int32_t i = 0; i < block_size; i++) {
+        if (block.getValue(i) < previous - 1.0e-3f) {
+          printf("FAIL %d frame blocks: not rising at frame %d\n",
+                 block_size, frame - block_size + i);
+          return 1;
+        }
+        previous = block.getValue(i);
+      }
+    }
+    if (!parameter.next(block_size).isConstant()
+        || parameter.getValue() != 1000.0f) {
+      printf("FAIL %d frame blocks: did not settle on the target\n",
+             block_size);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// A ramp that does not move must sound like the CONSTANT fast path, and
+// a glide must end up at the same pitch as a constant tone.
+int TestSupersawFollowsRamp() {
+  EngineContext context(kTestSampleRate);
+  const synth_float_t detunes[] = {0.9811f, 1.0f, 1.0204f};
+  const synth_float_t gains[] = {0.25f, 0.5f, 0.25f};
+  SupersawOscillatorBank constant_bank;
+  SupersawOscillatorBank ramp_bank;
+  SupersawOscillatorBank* banks[] = {&constant_bank, &ramp_bank};
+  for (SupersawOscillatorBank* bank : banks) {
+    bank->setEngineContext(&context);
+    bank->setOscillators(detunes, gains, 3);
+  }
+  const synth_float_t frequency = 440.0f;
+  double max_error = 0;
+  for (int32_t block = 0; block < 100; block++) {
+    constant_bank.generate(ControlBlock::constant(frequency), kNumFrames);
+    ramp_bank.generate(ControlBlock::ramp(frequency, 0.0f), kNumFrames);
+    for (int32_t i = 0; i < kNumFrames; i++) {
+      max_error = fmax(max_error,
+                       fabs(constant_bank.output[i] - ramp_bank.output[i]));
+    }
+  }
+  if (max_error > 1.0e-3) {
+    printf("FAIL a flat ramp differs from a constant by %g\n", max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = TestAddScaled();
+  failures += TestSmoothingIgnoresBlockSize();
+  failures += TestSupersawFollowsRamp();
+  printf("control_block_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the SampleCounters classification, the hardware flush of
+// ScopedDenormalGuard, and that the filters decay to exact silence without
+// it, as they must in wasm.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "DenormalGuard.h"
+#include "BiquadCascade.h"
+#include "BiquadFilter.h"
+#include "SimpleVoice.h"
+
+namespace {
+
+constexpr int32_t kFramesPerBlock = 64;
+
+int TestCounters() {
+  const float denormal = std::numeric_limits<float>::denorm_min() * 1000;
+  const float samples[] = {0.0f,
+                           -0.0f,
+                           1.0f,
+                           std::numeric_limits<float>::min(),
+                           denormal,
+                           -denormal,
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN()};
+  SampleCounters counters;
+  counters.count(samples, 9);
+  counters.count(samples, 5);
+  if (counters.samples != 14 || counters.denormals != 3 ||
+      counters.nonFinite != 3) {
+    printf("FAIL counted %lld samples, %lld denormal, %lld non-finite\n",
+           static_cast<long long>(counters.samples),
+           static_cast<long long>(counters.denormals),
+           static_cast<long long>(counters.nonFinite));
+    return 1;
+  }
+  return 0;
+}
+
+int TestHardwareFlush() {
+  if (!DenormalGuard::kHasHardwareFlush) {
+    printf("SKIP no hardware denormal flush\n");
+    return 0;
+  }
+  volatile float tiny = std::numeric_limits<float>::min();
+  volatile float half = 0.5f;
+  float flushed;
+  {
+    ScopedDenormalGuard outer;
+    ScopedDenormalGuard inner;
+    flushed = tiny * half;
+  }
+  float restored = tiny * half;
+  if (flushed != 0.0f || restored == 0.0f) {
+    printf("FAIL guarded result %g, unguarded result %g\n", flushed,
+           restored);
+    return 1;
+  }
+  return 0;
+}
+
+// Ring each filter with an impulse and check that its output reaches exact
+// zero without ever being denormal, with the hardware flush off.
+template <typename Filter>
+int TestFilterDecaysToZero(const char* name, Filter* filter) {
+  synth_float_t input[kFramesPerBlock] = {};
+  SampleCounters counters;
+  filter->setSampleCounters(&counters);
+  filter->setQ(10.0);
+  bool silent = false;
+  for (int32_t block = 0; block < 20000 && !silent; block++) {
+    input[0] = (block == 0) ? 1.0f : 0.0f;
+    filter->generate(input, ControlBlock::constant(50.0f), kFramesPerBlock);
+    silent = true;
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      silent = silent && filter->output[i] == 0.0f;
+  }
+  if (!silent || counters.denormals != 0 || counters.nonFinite != 0) {
+    printf("FAIL %s silent = %d, %lld denormal samples\n", name, silent,
+           static_cast<long long>(counters.denormals));
+    return 1;
+  }
+  return 0;
+}
+
+int TestZeroIfSmaller() {
+  const synth_float_t threshold = DenormalGuard::kFlushThreshold;
+  const synth_float_t values[] = {
+      0.0f, 1.0f, -1.0f, threshold, -threshold, threshold * 0.5f,
+      -threshold * 0.5f, std::numeric_limits<float>::min(),
+      std::numeric_limits<float>::quiet_NaN(), 1.0e-30f, -3.0e-15f, 7.0f};
+  constexpr int32_t kNumValues = sizeof(values) / sizeof(values[0]);
+  for (int32_t i = 0; i + SimdFloat::kWidth <= kNumValues;
+       i += SimdFloat::kWidth) {
+    synth_float_t flushed[SimdFloat::kWidth];
+    SimdFloat::load(values + i)
+        .zeroIfSmaller(SimdFloat::broadcast(threshold))
+        .store(flushed);
+    for (int32_t lane = 0; lane < SimdFloat::kWidth; lane++) {
+      synth_float_t expected = DenormalGuard::flush(values[i + lane]);
+      if (memcmp(&flushed[lane], &expected, sizeof(expected)) != 0) {
+        printf("FAIL zeroIfSmaller(%g) = %g, expected %g\n", values[i + lane],
+               flushed[lane], expected);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// The voice counts every stage that it renders.
+int TestVoiceCounting() {
+  constexpr int32_t kNumBlocks = 100;
+  SimpleVoice voice;
+  voice.setSampleCounting(true);
+  voice.setNoise(0.1f, NoiseGenerator::PINK);
+  voice.setPitch(60.0f);
+  voice.start();
+  for (int32_t block = 0; block < kNumBlocks; block++)
+    voice.generate(kFramesPerBlock);
+  for (int32_t stage = 0; stage < SimpleVoice::kNumStages; stage++) {
+    const SampleCounters& counters =
+        voice.getSampleCounters(static_cast<SimpleVoice::Stage>(stage));
+    if (counters.samples != kNumBlocks * kFramesPerBlock ||
+        counters.nonFinite != 0) {
+      printf("FAIL stage %d counted %lld samples, %lld non-finite\n", stage,
+             static_cast<long long>(counters.samples),
+             static_cast<long long>(counters.nonFinite));
+      return 1;
+    }
+  }
+  voice.setSampleCounting(false);
+  voice.generate(kFramesPerBlock);
+  if (voice.getSampleCounters(SimpleVoice::kVoiceOutput).samples !=
+      kNumBlocks * kFramesPerBlock) {
+    printf("FAIL counting did not stop\n");
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestCounters();
+  failures += TestHardwareFlush();
+  BiquadFilter filter;
+  failures += TestFilterDecaysToZero("BiquadFilter", &filter);
+  BiquadCascade cascade;
+  failures += TestFilterDecaysToZero("BiquadCascade", &cascade);
+  failures += TestZeroIfSmaller();
+  failures += TestVoiceCounting();
+  printf("denormal_guard_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
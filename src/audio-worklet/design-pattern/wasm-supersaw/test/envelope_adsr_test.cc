@@ -0,0 +1,205 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the segment based EnvelopeADSR against a sample by sample model of
+// the same envelope, for several block sizes and gate patterns.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "SynthMark.h"
+#include "EngineContext.h"
+#include "EnvelopeADSR.h"
+#include "SynthSimd.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kTotalFrames = 40000;
+// The vector geometric series rounds differently from one multiply per
+// sample.
+constexpr float kTolerance = 1.0e-4f;
+
+struct Settings {
+  const char* name;
+  synth_float_t attack;
+  synth_float_t decay;
+  synth_float_t sustain;
+  synth_float_t release;
+};
+
+// Frame at which the gate toggles, starting with the gate off.
+const int32_t kGateChanges[] = {100, 5000, 9000, 9300, 20000, 26000};
+constexpr int32_t kNumGateChanges =
+    sizeof(kGateChanges) / sizeof(kGateChanges[0]);
+
+bool GateAt(int32_t frame) {
+  bool gate = false;
+  for (int32_t i = 0; i < kNumGateChanges && kGateChanges[i] <= frame; i++)
+    gate = !gate;
+  return gate;
+}
+
+// One sample at a time, with a state switch per sample.
+std::vector<float> RenderModel(const Settings& settings) {
+  enum State { kIdle, kAttack, kDecay, kSustain, kRelease };
+  const double min_duration = 1.0 / 100000.0;
+  const float increment = 1.0f / (settings.attack * kTestSampleRate);
+  const float decay_scaler = static_cast<float>(
+      pow(SYNTHMARK_DB90, 1.0 / (settings.decay * kTestSampleRate)));
+  const float release_scaler = static_cast<float>(
+      pow(SYNTHMARK_DB90, 1.0 / (settings.release * kTestSampleRate)));
+  const bool to_sustain = settings.sustain >= SYNTHMARK_DB96;
+  const float decay_target = to_sustain ? settings.sustain : SYNTHMARK_DB96;
+
+  std::vector<float> output(kTotalFrames);
+  State state = kIdle;
+  float level = 0;
+  for (int32_t i = 0; i < kTotalFrames; i++) {
+    const bool gate = GateAt(i);
+    // Apply transitions that the gate causes before the sample.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      if (state == kIdle && gate) {
+        state = kAttack;
+        changed = true;
+      } else if ((state == kAttack || state == kDecay || state == kSustain)
+                 && !gate) {
+        state = kRelease;
+        changed = true;
+      } else if (state == kRelease && gate) {
+        state = kAttack;
+        changed = true;
+      }
+      if (state == kAttack && settings.attack < min_duration) {
+        level = 1.0f;
+        state = kDecay;
+      }
+      if (state == kDecay && settings.decay < min_duration)
+        state = kSustain;
+    }
+    switch (state) {
+      case kIdle:
+        output[i] = level;
+        break;
+      case kAttack:
+        level += increment;
+        if (level >= 1.0f) {
+          level = 1.0f;
+          state = (settings.decay < min_duration) ? kSustain : kDecay;
+        }
+        output[i] = level;
+        break;
+      case kDecay:
+        output[i] = level;
+        level *= decay_scaler;
+        if (level < decay_target) {
+          if (to_sustain) {
+            level = settings.sustain;
+            state = kSustain;
+          } else {
+            level = 0;
+            state = kIdle;
+          }
+        }
+        break;
+      case kSustain:
+        level = settings.sustain;
+        output[i] = level;
+        break;
+      case kRelease:
+        output[i] = level;
+        level *= release_scaler;
+        if (level < SYNTHMARK_DB96) {
+          level = 0;
+          state = kIdle;
+        }
+        break;
+    }
+  }
+  return output;
+}
+
+// Split blocks at the gate changes, like Synthesizer does for note events.
+std::vector<float> RenderEnvelope(const Settings& settings,
+                                  int32_t frames_per_block) {
+  EngineContext context(kTestSampleRate);
+  EnvelopeADSR envelope;
+  envelope.setEngineContext(&context);
+  envelope.setAttackTime(settings.attack);
+  envelope.setDecayTime(settings.decay);
+  envelope.setSustainLevel(settings.sustain);
+  envelope.setReleaseTime(settings.release);
+
+  std::vector<float> output(kTotalFrames);
+  int32_t frame = 0;
+  while (frame < kTotalFrames) {
+    int32_t count = frames_per_block;
+    if (count > kTotalFrames - frame)
+      count = kTotalFrames - frame;
+    for (int32_t i = 0; i < kNumGateChanges; i++) {
+      if (kGateChanges[i] > frame && kGateChanges[i] - frame < count)
+        count = kGateChanges[i] - frame;
+    }
+    envelope.setGate(GateAt(frame));
+    envelope.generate(count);
+    for (int32_t i = 0; i < count; i++)
+      output[frame + i] = envelope.output[i];
+    frame += count;
+  }
+  return output;
+}
+
+int TestSettings(const Settings& settings) {
+  const std::vector<float> expected = RenderModel(settings);
+  const int32_t block_sizes[] = {SYNTHMARK_MAX_FRAMES_PER_RENDER, 1, 13, 64};
+  for (int32_t frames_per_block : block_sizes) {
+    const std::vector<float> actual =
+        RenderEnvelope(settings, frames_per_block);
+    for (int32_t i = 0; i < kTotalFrames; i++) {
+      if (fabsf(actual[i] - expected[i]) > kTolerance) {
+        printf("FAIL %s, %d frames per block: frame %d is %f, expected %f\n",
+               settings.name, frames_per_block, i, actual[i], expected[i]);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  // Stage times are chosen so that no stage ends exactly on a sample.
+  const Settings settings[] = {
+      {"voice", 0.0213f, 0.0217f, 0.707f, 0.0523f},
+      {"slow", 0.0731f, 0.3117f, 0.25f, 0.4129f},
+      {"no sustain", 0.0113f, 0.0419f, 0.0f, 0.0311f},
+      {"instant attack", 0.0f, 0.0289f, 0.5f, 0.0371f},
+      {"instant decay", 0.0157f, 0.0f, 0.6f, 0.0247f},
+  };
+  int failures = 0;
+  for (const Settings& s : settings)
+    failures += TestSettings(s);
+  printf("envelope_adsr_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
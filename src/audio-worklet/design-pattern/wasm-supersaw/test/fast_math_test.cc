@@ -0,0 +1,182 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the FastMath errors documented in FastMath.h against <cmath>, and
+// that the block and single float versions give the same results.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "FastMath.h"
+#include "SynthTools.h"
+
+namespace {
+
+constexpr int32_t kNumInputs = 20000;
+
+typedef void (*BlockFunction)(const synth_float_t*, synth_float_t*, int32_t);
+typedef synth_float_t (*SingleFunction)(synth_float_t);
+
+// Tolerances are the documented errors with a little headroom for the
+// rounding differences between instruction sets.
+int TestFunction(const char* name, BlockFunction block, SingleFunction single,
+                 double (*reference)(double), double min_input,
+                 double max_input, bool log_spaced, bool relative,
+                 double tolerance) {
+  synth_float_t inputs[kNumInputs];
+  synth_float_t outputs[kNumInputs];
+  for (int32_t i = 0; i < kNumInputs; i++) {
+    double position = static_cast<double>(i) / (kNumInputs - 1);
+    inputs[i] = static_cast<synth_float_t>(
+        log_spaced ? min_input * pow(max_input / min_input, position)
+                   : min_input + (max_input - min_input) * position);
+  }
+  // An odd count leaves a padded tail vector.
+  const int32_t count = kNumInputs - 3;
+  block(inputs, outputs, count);
+  double max_error = 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (outputs[i] != single(inputs[i])) {
+      printf("FAIL %s block result for %g is %g, expected %g\n", name,
+             inputs[i], outputs[i], single(inputs[i]));
+      return 1;
+    }
+    double expected = reference(inputs[i]);
+    double error = fabs(outputs[i] - expected);
+    if (relative)
+      error /= fabs(expected);
+    max_error = fmax(max_error, error);
+  }
+  if (max_error > tolerance) {
+    printf("FAIL %s max error = %g, limit %g\n", name, max_error, tolerance);
+    return 1;
+  }
+  return 0;
+}
+
+double Exp2(double x) {
+  return exp2(x);
+}
+
+double Log2(double x) {
+  return log2(x);
+}
+
+double Sin(double x) {
+  return sin(x);
+}
+
+double Cos(double x) {
+  return cos(x);
+}
+
+double Tanh(double x) {
+  return tanh(x);
+}
+
+int TestPow() {
+  double max_error = 0;
+  for (double x = 0.01; x <= 100.0; x *= 1.07) {
+    for (double y = -4.0; y <= 4.0; y += 0.25) {
+      synth_float_t fx = static_cast<synth_float_t>(x);
+      synth_float_t fy = static_cast<synth_float_t>(y);
+      double expected = pow(static_cast<double>(fx), fy);
+      max_error = fmax(max_error,
+                       fabs(FastMath::pow(fx, fy) - expected) / expected);
+    }
+  }
+  if (max_error > 2.5e-6) {
+    printf("FAIL pow max error = %g\n", max_error);
+    return 1;
+  }
+  return 0;
+}
+
+int TestSynthTools() {
+  double max_error = 0;
+  for (int32_t i = 0; i <= 1000; i++) {
+    synth_float_t phase = static_cast<synth_float_t>(M_PI * (i - 500) / 500.0);
+    max_error = fmax(max_error, fabs(SynthTools::fastSine(phase) -
+                                     sin(static_cast<double>(phase))));
+    max_error = fmax(max_error, fabs(SynthTools::fastCosine(phase) -
+                                     cos(static_cast<double>(phase))));
+  }
+  if (max_error > 1.0e-6) {
+    printf("FAIL fastSine and fastCosine max error = %g\n", max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  using FM = FastMath;
+  int failures = 0;
+  failures += TestFunction("exp2 FAST", FM::exp2<FM::FAST>,
+                           FM::exp2<FM::FAST>, Exp2, -20.0, 20.0, false, true,
+                           1.2e-4);
+  failures += TestFunction("exp2 MEDIUM", FM::exp2<FM::MEDIUM>,
+                           FM::exp2<FM::MEDIUM>, Exp2, -20.0, 20.0, false,
+                           true, 4.5e-6);
+  failures += TestFunction("exp2 ACCURATE", FM::exp2<FM::ACCURATE>,
+                           FM::exp2<FM::ACCURATE>, Exp2, -20.0, 20.0, false,
+                           true, 2.5e-7);
+  failures += TestFunction("log2 FAST", FM::log2<FM::FAST>,
+                           FM::log2<FM::FAST>, Log2, 1.0e-6, 1.0e6, true,
+                           false, 4.0e-4);
+  failures += TestFunction("log2 MEDIUM", FM::log2<FM::MEDIUM>,
+                           FM::log2<FM::MEDIUM>, Log2, 1.0e-6, 1.0e6, true,
+                           false, 1.0e-5);
+  failures += TestFunction("log2 ACCURATE", FM::log2<FM::ACCURATE>,
+                           FM::log2<FM::ACCURATE>, Log2, 1.0e-6, 1.0e6, true,
+                           false, 1.5e-6);
+  failures += TestFunction("sin FAST", FM::sin<FM::FAST>, FM::sin<FM::FAST>,
+                           Sin, -100.0, 100.0, false, false, 5.5e-4);
+  failures += TestFunction("sin MEDIUM", FM::sin<FM::MEDIUM>,
+                           FM::sin<FM::MEDIUM>, Sin, -100.0, 100.0, false,
+                           false, 2.0e-5);
+  failures += TestFunction("sin ACCURATE", FM::sin<FM::ACCURATE>,
+                           FM::sin<FM::ACCURATE>, Sin, -100.0, 100.0, false,
+                           false, 5.0e-6);
+  failures += TestFunction("cos FAST", FM::cos<FM::FAST>, FM::cos<FM::FAST>,
+                           Cos, -100.0, 100.0, false, false, 5.5e-4);
+  failures += TestFunction("cos MEDIUM", FM::cos<FM::MEDIUM>,
+                           FM::cos<FM::MEDIUM>, Cos, -100.0, 100.0, false,
+                           false, 2.5e-5);
+  failures += TestFunction("cos ACCURATE", FM::cos<FM::ACCURATE>,
+                           FM::cos<FM::ACCURATE>, Cos, -100.0, 100.0, false,
+                           false, 9.0e-6);
+  failures += TestFunction("tanh FAST", FM::tanh<FM::FAST>,
+                           FM::tanh<FM::FAST>, Tanh, -10.0, 10.0, false, false,
+                           6.0e-5);
+  failures += TestFunction("tanh MEDIUM", FM::tanh<FM::MEDIUM>,
+                           FM::tanh<FM::MEDIUM>, Tanh, -10.0, 10.0, false,
+                           false, 2.5e-6);
+  failures += TestFunction("tanh ACCURATE", FM::tanh<FM::ACCURATE>,
+                           FM::tanh<FM::ACCURATE>, Tanh, -10.0, 10.0, false,
+                           false, 2.5e-7);
+  failures += TestPow();
+  failures += TestSynthTools();
+  printf("fast_math_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the compile time tables against <cmath>, and that the block
+// lookup matches the lookup of one sample at a time.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "LookupTable.h"
+#include "PitchToFrequency.h"
+
+// The tables are built by the compiler.
+static_assert(LookupTables::kPowerOfTwo.getEntry(0) == 1.0f,
+              "2^0 must be exact");
+static_assert(LookupTables::kPowerOfTwo.lookup(1.0f) == 2.0f,
+              "2^1 must be exact");
+static_assert(LookupTables::kSine.lookup(0.25f) > 0.9999f,
+              "sine must peak a quarter of the way through the cycle");
+
+namespace {
+
+constexpr int32_t kNumInputs = 1000;
+
+template <int32_t kNumEntries>
+int TestTable(const char* name, const LookupTable<kNumEntries>& table,
+              double (*reference)(double), double min_input,
+              double max_input, double tolerance) {
+  // Inputs run a little past both ends to cover the clamping.
+  synth_float_t inputs[kNumInputs];
+  const double margin = 0.1 * (max_input - min_input);
+  for (int32_t i = 0; i < kNumInputs; i++) {
+    inputs[i] = static_cast<synth_float_t>(
+        min_input - margin + (max_input - min_input + 2 * margin) * i /
+        (kNumInputs - 1));
+  }
+  // An odd count leaves a tail for the scalar loop.
+  const int32_t count = kNumInputs - 3;
+  synth_float_t outputs[kNumInputs];
+  table.lookup(inputs, outputs, count);
+  double max_error = 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (outputs[i] != table.lookup(inputs[i])) {
+      printf("FAIL %s block lookup of %g is %g, expected %g\n", name,
+             inputs[i], outputs[i], table.lookup(inputs[i]));
+      return 1;
+    }
+    double input = fmin(fmax(inputs[i], min_input), max_input);
+    max_error = fmax(max_error, fabs(outputs[i] - reference(input)));
+  }
+  if (max_error > tolerance) {
+    printf("FAIL %s max error = %g\n", name, max_error);
+    return 1;
+  }
+  return 0;
+}
+
+double PowerOfTwo(double x) {
+  return pow(2.0, x);
+}
+
+double SineCycle(double x) {
+  return sin(2.0 * M_PI * x);
+}
+
+double Tanh(double x) {
+  return tanh(x);
+}
+
+double Exp(double x) {
+  return exp(x);
+}
+
+int TestPitchToFrequency() {
+  synth_float_t pitches[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+  synth_float_t frequencies[SYNTHMARK_MAX_FRAMES_PER_RENDER];
+  for (int32_t i = 0; i < SYNTHMARK_MAX_FRAMES_PER_RENDER; i++)
+    pitches[i] = 127.0f * i / (SYNTHMARK_MAX_FRAMES_PER_RENDER - 1);
+  PitchToFrequency::generate(pitches, frequencies,
+                             SYNTHMARK_MAX_FRAMES_PER_RENDER);
+  double max_cents = 0;
+  for (int32_t i = 0; i < SYNTHMARK_MAX_FRAMES_PER_RENDER; i++) {
+    double expected = PitchToFrequency::convertPitchToFrequency(pitches[i]);
+    max_cents = fmax(max_cents,
+                     fabs(1200.0 * log2(frequencies[i] / expected)));
+  }
+  if (max_cents > 0.05) {
+    printf("FAIL pitch to frequency is off by %g cents\n", max_cents);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestTable("pow2", LookupTables::kPowerOfTwo, PowerOfTwo, 0.0,
+                        1.0, 3.0e-5);
+  failures += TestTable("sine", LookupTables::kSine, SineCycle, 0.0, 1.0,
+                        3.0e-5);
+  failures += TestTable("tanh", LookupTables::kTanh, Tanh, -5.0, 5.0, 5.0e-5);
+  failures += TestTable("exp", LookupTables::kExp, Exp, -8.0, 0.0, 5.0e-5);
+  failures += TestPitchToFrequency();
+  printf("lookup_table_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the real-time audit catches each kind of allocation inside a
+// real-time section and that rendering with events, control changes and voice
+// stealing does not trigger it. Without SYNTHMARK_RT_AUDIT only the second
+// part does anything.
+//
+// Run with `make test` or `make audit` in the parent directory.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+
+#include "RealtimeAudit.h"
+#include "Synthesizer.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+
+// Needs an aligned operator new.
+struct alignas(64) CacheLine {
+  float samples[16];
+};
+
+// Each allocation is checked on its own so a failure names the call.
+// volatile keeps the compiler from removing the pairs. The reports they
+// print on stderr are expected.
+template <typename Function>
+int ExpectViolations(const char* name, int32_t expected, Function function) {
+  {
+    ScopedRealtimeSection realtime;
+    function();
+  }
+  int32_t count = RealtimeAudit::getViolationCount();
+  RealtimeAudit::resetViolationCount();
+  if (count != expected) {
+    printf("FAIL expected %d violations from %s, got %d\n", expected, name,
+           count);
+    return 1;
+  }
+  return 0;
+}
+
+int TestAllocationIsReported() {
+  int failures = 0;
+#if SYNTHMARK_RT_AUDIT
+  failures += ExpectViolations("malloc and free", 2, [] {
+    void* volatile memory = malloc(16);
+    free(memory);
+  });
+  failures += ExpectViolations("aligned_alloc and free", 2, [] {
+    void* volatile memory = aligned_alloc(64, 64);
+    free(memory);
+  });
+  failures += ExpectViolations("posix_memalign and free", 2, [] {
+    void* memory = nullptr;
+    if (posix_memalign(&memory, 64, 64) == 0)
+      free(*static_cast<void* volatile*>(&memory));
+  });
+  failures += ExpectViolations("memalign and free", 2, [] {
+    void* volatile memory = memalign(64, 64);
+    free(memory);
+  });
+  failures += ExpectViolations("aligned new and delete", 2, [] {
+    CacheLine* volatile line = new CacheLine();
+    delete line;
+  });
+  failures += ExpectViolations("aligned new[] and delete[]", 2, [] {
+    CacheLine* volatile lines = new CacheLine[4];
+    delete[] lines;
+  });
+#endif
+  return failures;
+}
+
+int TestRenderIsRealtimeSafe() {
+  Synthesizer synth(kTestSampleRate, 4);
+  float output[128];
+  for (int32_t block = 0; block < 100; block++) {
+    // More notes than voices so that voices get stolen.
+    synth.noteOn(48 + block % 24);
+    if (block % 3 == 0)
+      synth.noteOff(48 + (block + 12) % 24);
+    // Control mode changes and parameter dumps used to print.
+    synth.controlChange(50 + block % 3, 127);
+    synth.controlChange(5, 127);
+    synth.controlChange(2, block % 128);
+    synth.render(output, 1 + block % 128);
+  }
+  int32_t count = RealtimeAudit::getViolationCount();
+  if (count != 0) {
+    printf("FAIL render made %d real-time violations\n", count);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestAllocationIsReported();
+  failures += TestRenderIsRealtimeSafe();
+  printf("realtime_audit_test (%s%s): %s\n", SYNTHMARK_SIMD_NAME,
+         SYNTHMARK_RT_AUDIT ? ", audit" : "",
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
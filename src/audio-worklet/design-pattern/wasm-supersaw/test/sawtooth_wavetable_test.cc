@@ -0,0 +1,141 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the wavetable sawtooth picks levels that stay below Nyquist
+// and matches an additive sawtooth with the same harmonics.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "EngineContext.h"
+#include "SawtoothOscillatorWavetable.h"
+#include "SupersawOscillatorBank.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kFramesPerBlock = 128;
+constexpr int32_t kNumBlocks = 16;
+// Linear interpolation error of the shortest tables.
+constexpr double kTolerance = 2.0e-3;
+
+// Rising sawtooth between -1.0 and +1.0 with the first num_harmonics.
+double AdditiveSawtooth(double phase, int32_t num_harmonics) {
+  const double theta = M_PI * (phase + 1.0);
+  double sum = 0;
+  for (int32_t h = 1; h <= num_harmonics; h++)
+    sum += sin(h * theta) / h;
+  return -(2.0 / M_PI) * sum;
+}
+
+int TestLevelSelection() {
+  for (double increment = 1.0e-6; increment < 1.0; increment *= 1.01) {
+    int32_t level = SawtoothWavetable::selectLevel(increment);
+    double top = SawtoothWavetable::getNumHarmonics(level) * increment;
+    if (level < SawtoothWavetable::kNumLevels - 1 && top > 1.0) {
+      printf("FAIL level %d aliases at increment %g\n", level, increment);
+      return 1;
+    }
+    if (level > 0 && 2.0 * top <= 1.0) {
+      printf("FAIL level %d is too dark at increment %g\n", level, increment);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestOscillatorMatchesAdditive(synth_float_t frequency) {
+  EngineContext context(kTestSampleRate);
+  SawtoothOscillatorWavetable oscillator;
+  oscillator.setEngineContext(&context);
+  const synth_float_t increment = 2.0 * frequency * context.getSamplePeriod();
+  const int32_t num_harmonics = SawtoothWavetable::getNumHarmonics(
+      SawtoothWavetable::selectLevel(increment));
+
+  synth_float_t phase = 0;
+  double max_error = 0;
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    oscillator.generate(frequency, kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++) {
+      double expected = AdditiveSawtooth(phase, num_harmonics);
+      max_error = fmax(max_error, fabs(oscillator.output[i] - expected));
+      phase += increment;
+      if (phase > 1.0)
+        phase -= 2.0;
+    }
+  }
+  if (max_error > kTolerance) {
+    printf("FAIL %g Hz with %d harmonics is off by %g\n", frequency,
+           num_harmonics, max_error);
+    return 1;
+  }
+  return 0;
+}
+
+int TestSupersawWavetableSource() {
+  EngineContext context(kTestSampleRate);
+  SupersawOscillatorBank bank;
+  bank.setEngineContext(&context);
+  const synth_float_t detunes[] = {0.9811f, 1.0f, 1.0204f};
+  const synth_float_t gains[] = {0.25f, 0.5f, 0.25f};
+  const int32_t count = 3;
+  bank.setOscillators(detunes, gains, count);
+  bank.setSource(SupersawOscillatorBank::WAVETABLE);
+  const synth_float_t frequency = 3520.0f;
+
+  synth_float_t phases[count] = {};
+  double max_error = 0;
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    bank.generate(frequency, kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++) {
+      double expected = 0;
+      for (int32_t n = 0; n < count; n++) {
+        const synth_float_t increment =
+            2.0f * frequency * detunes[n] * context.getSamplePeriod();
+        expected += gains[n] * AdditiveSawtooth(phases[n],
+            SawtoothWavetable::getNumHarmonics(
+                SawtoothWavetable::selectLevel(increment)));
+        phases[n] += increment;
+        if (phases[n] > 1.0f)
+          phases[n] -= 2.0f;
+      }
+      max_error = fmax(max_error, fabs(bank.output[i] - expected));
+    }
+  }
+  if (max_error > kTolerance) {
+    printf("FAIL wavetable supersaw is off by %g\n", max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = TestLevelSelection();
+  const synth_float_t frequencies[] = {27.5f, 110.0f, 440.0f, 1760.0f,
+                                       5000.0f, 12000.0f, 20000.0f};
+  for (synth_float_t frequency : frequencies)
+    failures += TestOscillatorMatchesAdditive(frequency);
+  failures += TestSupersawWavetableSource();
+  printf("sawtooth_wavetable_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
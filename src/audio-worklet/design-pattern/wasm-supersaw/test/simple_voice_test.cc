@@ -0,0 +1,106 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that a SimpleVoice becomes inactive once its amp envelope is idle,
+// and that starting it again sounds like a fresh voice.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "EngineContext.h"
+#include "SimpleVoice.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kFramesPerBlock = 64;
+
+synth_float_t RenderPeak(SimpleVoice* voice, int32_t num_blocks) {
+  synth_float_t peak = 0;
+  for (int32_t block = 0; block < num_blocks; block++) {
+    voice->generate(kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      peak = fmaxf(peak, fabsf(voice->output[i]));
+  }
+  return peak;
+}
+
+int TestIdleAndRestart() {
+  EngineContext context(kTestSampleRate);
+  SimpleVoice voice;
+  voice.setEngineContext(&context);
+  if (voice.isActive()) {
+    printf("FAIL a voice that was never started is active\n");
+    return 1;
+  }
+
+  voice.setPitch(60);
+  voice.start();
+  if (!voice.isActive() || RenderPeak(&voice, 100) == 0) {
+    printf("FAIL start() did not make the voice sound\n");
+    return 1;
+  }
+
+  // The default release is 50 msec, so a second is plenty.
+  voice.stop();
+  int32_t blocks = 0;
+  while (voice.isActive() && blocks < kTestSampleRate / kFramesPerBlock) {
+    voice.generate(kFramesPerBlock);
+    blocks++;
+  }
+  if (voice.isActive()) {
+    printf("FAIL voice still active %d blocks after stop()\n", blocks);
+    return 1;
+  }
+
+  // Nothing of the last note, such as the filter tail, may leak into the
+  // next one. A leaked tail is around 1e-3, rounding in the oscillator
+  // state that restarting keeps is around 1e-8.
+  SimpleVoice fresh;
+  fresh.setEngineContext(&context);
+  voice.setRandomSeed(7);
+  fresh.setRandomSeed(7);
+  voice.setPitch(67);
+  fresh.setPitch(67);
+  voice.start();
+  fresh.start();
+  synth_float_t max_error = 0;
+  for (int32_t block = 0; block < 100; block++) {
+    voice.generate(kFramesPerBlock);
+    fresh.generate(kFramesPerBlock);
+    for (int32_t i = 0; i < kFramesPerBlock; i++)
+      max_error = fmaxf(max_error, fabsf(voice.output[i] - fresh.output[i]));
+  }
+  if (max_error > 1.0e-5f) {
+    printf("FAIL restarted voice differs from a fresh one by %g\n",
+           max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = TestIdleAndRestart();
+  printf("simple_voice_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
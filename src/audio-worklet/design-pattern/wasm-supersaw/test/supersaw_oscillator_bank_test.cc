@@ -0,0 +1,140 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that SupersawOscillatorBank matches a mix of individual
+// SawtoothOscillatorDPW instances, for the classic seven oscillators and for
+// the unison counts set up by setUnison().
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthTools.h"
+#include "SawtoothOscillator.h"
+#include "SawtoothOscillatorDPW.h"
+#include "SupersawOscillatorBank.h"
+
+namespace {
+
+constexpr int32_t kNumOscillators = 7;
+constexpr int32_t kNumBlocks = 200;
+// The bank multiplies by a reciprocal where the reference divides.
+constexpr synth_float_t kTolerance = 1.0e-4f;
+
+const synth_float_t kDetune[kNumOscillators] =
+    {0.8908, 0.9382, 0.9811, 1, 1.0204, 1.0633, 1.1077};
+const synth_float_t kGains[kNumOscillators] =
+    {0.0789, 0.1052, 0.1578, 0.3157, 0.1578, 0.1052, 0.07894};
+
+synth_float_t MeasureError(SupersawOscillatorBank* bank,
+                           const synth_float_t* detunes,
+                           const synth_float_t* gains, int32_t count,
+                           synth_float_t frequency) {
+  SawtoothOscillatorDPW reference[SUPERSAW_MAX_OSCILLATORS];
+  synth_float_t max_error = 0;
+  for (int32_t block = 0; block < kNumBlocks; block++) {
+    bank->generate(frequency, SYNTHMARK_FRAMES_PER_RENDER);
+    synth_float_t expected[SYNTHMARK_FRAMES_PER_RENDER] = {};
+    for (int32_t osc = 0; osc < count; osc++) {
+      reference[osc].generate(frequency * detunes[osc],
+                              SYNTHMARK_FRAMES_PER_RENDER);
+      SynthTools::addBuffers(reference[osc].output, gains[osc], expected,
+                             SYNTHMARK_FRAMES_PER_RENDER);
+    }
+    for (int32_t i = 0; i < SYNTHMARK_FRAMES_PER_RENDER; i++)
+      max_error = fmaxf(max_error, fabsf(expected[i] - bank->output[i]));
+  }
+  return max_error;
+}
+
+int TestFrequency(synth_float_t frequency) {
+  SupersawOscillatorBank bank;
+  bank.setOscillators(kDetune, kGains, kNumOscillators);
+  synth_float_t max_error =
+      MeasureError(&bank, kDetune, kGains, kNumOscillators, frequency);
+  if (max_error > kTolerance) {
+    printf("FAIL frequency = %g, max error = %g\n", frequency, max_error);
+    return 1;
+  }
+  return 0;
+}
+
+int TestUnison(int32_t count) {
+  const synth_float_t spread = 0.8f;
+  SupersawOscillatorBank bank;
+  bank.setUnison(count, spread);
+  if (bank.getNumOscillators() != count) {
+    printf("FAIL unison %d has %d oscillators\n", count,
+           bank.getNumOscillators());
+    return 1;
+  }
+  synth_float_t detunes[SUPERSAW_MAX_OSCILLATORS];
+  synth_float_t gains[SUPERSAW_MAX_OSCILLATORS];
+  synth_float_t gain_sum = 0;
+  for (int32_t osc = 0; osc < count; osc++) {
+    detunes[osc] = bank.getDetune(osc);
+    gains[osc] = bank.getGain(osc);
+    gain_sum += gains[osc];
+  }
+  if (fabsf(gain_sum - 1.0f) > 1.0e-5f) {
+    printf("FAIL unison %d gains add up to %g\n", count, gain_sum);
+    return 1;
+  }
+  const synth_float_t outer = (count == 1) ? 0.0f
+      : static_cast<synth_float_t>(SUPERSAW_MAX_DETUNE) * spread;
+  for (int32_t osc = 0; osc < count; osc++) {
+    const int32_t mirror = count - 1 - osc;
+    if (fabsf(detunes[osc] + detunes[mirror] - 2.0f) > 1.0e-6f ||
+        gains[osc] != gains[mirror]) {
+      printf("FAIL unison %d is not symmetric at %d\n", count, osc);
+      return 1;
+    }
+    if (fabsf(detunes[osc] - 1.0f) > outer + 1.0e-6f) {
+      printf("FAIL unison %d detune %g is out of range\n", count,
+             detunes[osc]);
+      return 1;
+    }
+  }
+  if (fabsf(detunes[0] - (1.0f - outer)) > 1.0e-6f) {
+    printf("FAIL unison %d lowest detune is %g\n", count, detunes[0]);
+    return 1;
+  }
+  synth_float_t max_error = MeasureError(&bank, detunes, gains, count, 440.0f);
+  if (max_error > kTolerance) {
+    printf("FAIL unison %d, max error = %g\n", count, max_error);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  // Include one frequency below the DPW cutoff to cover the raw path.
+  const synth_float_t frequencies[] = {0.05f, 55.0f, 261.63f, 2000.0f,
+                                       9000.0f};
+  for (synth_float_t frequency : frequencies)
+    failures += TestFrequency(frequency);
+  for (int32_t count = 1; count <= SUPERSAW_MAX_OSCILLATORS; count++)
+    failures += TestUnison(count);
+  printf("supersaw_oscillator_bank_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that SynthRandom runs xoshiro128++ in every lane, that a seed
+// reproduces the sequence, that the block fills stay in range, and that
+// pink noise has more energy in the low frequencies than white noise.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "SynthRandom.h"
+#include "NoiseGenerator.h"
+
+namespace {
+
+constexpr int32_t kNumSamples = 1 << 16;
+
+uint32_t RotateLeft(uint32_t x, int bits) {
+  return (x << bits) | (x >> (32 - bits));
+}
+
+// Reference xoshiro128++ from the published algorithm, one lane at a time.
+uint32_t Xoshiro128PlusPlus(uint32_t* s) {
+  const uint32_t result = RotateLeft(s[0] + s[3], 7) + s[0];
+  const uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = RotateLeft(s[3], 11);
+  return result;
+}
+
+uint64_t SplitMix64(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+int TestMatchesReference() {
+  constexpr int32_t kLanes = SynthRandom::kNumLanes;
+  uint32_t states[kLanes][4];
+  uint64_t seed = 42;
+  for (int32_t lane = 0; lane < kLanes; lane++) {
+    uint64_t low = SplitMix64(&seed);
+    uint64_t high = SplitMix64(&seed);
+    states[lane][0] = static_cast<uint32_t>(low);
+    states[lane][1] = static_cast<uint32_t>(low >> 32);
+    states[lane][2] = static_cast<uint32_t>(high);
+    states[lane][3] = static_cast<uint32_t>(high >> 32);
+  }
+  SynthRandom random(42);
+  for (int32_t step = 0; step < 1000; step++) {
+    for (int32_t lane = 0; lane < kLanes; lane++) {
+      uint32_t expected = Xoshiro128PlusPlus(states[lane]);
+      uint32_t actual = random.nextInteger();
+      if (actual != expected) {
+        printf("FAIL step %d lane %d is %u, expected %u\n", step, lane,
+               actual, expected);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int TestSeedReproducesSequence() {
+  static synth_float_t first[kNumSamples];
+  static synth_float_t second[kNumSamples];
+  SynthRandom random(7);
+  random.fillBipolar(first, kNumSamples);
+  random.setSeed(7);
+  // Smaller blocks of whole steps must give the same sequence.
+  for (int32_t i = 0; i < kNumSamples; i += SynthRandom::kNumLanes * 3) {
+    int32_t count = SynthRandom::kNumLanes * 3;
+    if (count > kNumSamples - i)
+      count = kNumSamples - i;
+    random.fillBipolar(second + i, count);
+  }
+  for (int32_t i = 0; i < kNumSamples; i++) {
+    if (first[i] != second[i]) {
+      printf("FAIL seed did not reproduce sample %d\n", i);
+      return 1;
+    }
+  }
+  SynthRandom other(8);
+  other.fillBipolar(second, kNumSamples);
+  int32_t same = 0;
+  for (int32_t i = 0; i < kNumSamples; i++)
+    same += first[i] == second[i];
+  if (same > 16) {
+    printf("FAIL seeds 7 and 8 share %d samples\n", same);
+    return 1;
+  }
+  return 0;
+}
+
+int TestFillRange(bool bipolar) {
+  static synth_float_t samples[kNumSamples];
+  SynthRandom random;
+  if (bipolar)
+    random.fillBipolar(samples, kNumSamples);
+  else
+    random.fillUniform(samples, kNumSamples);
+  const double low = bipolar ? -1.0 : 0.0;
+  double sum = 0;
+  for (int32_t i = 0; i < kNumSamples; i++) {
+    if (samples[i] < low || samples[i] >= 1.0) {
+      printf("FAIL sample %d = %g is out of range\n", i, samples[i]);
+      return 1;
+    }
+    sum += samples[i];
+  }
+  const double mean = sum / kNumSamples;
+  if (fabs(mean - (low + 1.0) / 2) > 0.01) {
+    printf("FAIL mean = %g\n", mean);
+    return 1;
+  }
+  return 0;
+}
+
+// Average of a one pole lowpass at about 100 Hz, squared.
+double LowFrequencyPower(NoiseGenerator::Color color) {
+  NoiseGenerator noise;
+  noise.setColor(color);
+  SynthRandom random;
+  double lowpass = 0;
+  double power = 0;
+  int32_t count = 0;
+  for (int32_t block = 0; block < 2000; block++) {
+    noise.generate(random, SYNTHMARK_FRAMES_PER_RENDER);
+    for (int32_t i = 0; i < SYNTHMARK_FRAMES_PER_RENDER; i++) {
+      lowpass += 0.013 * (noise.output[i] - lowpass);
+      power += lowpass * lowpass;
+      count++;
+    }
+  }
+  return power / count;
+}
+
+int TestPinkNoise() {
+  // Pink noise is quieter overall, yet has more low frequency power.
+  const double white = LowFrequencyPower(NoiseGenerator::WHITE);
+  const double pink = LowFrequencyPower(NoiseGenerator::PINK);
+  if (pink < 2.0 * white) {
+    printf("FAIL pink low frequency power %g vs white %g\n", pink, white);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  failures += TestMatchesReference();
+  failures += TestSeedReproducesSequence();
+  failures += TestFillRange(false);
+  failures += TestFillRange(true);
+  failures += TestPinkNoise();
+  printf("synth_random_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the SynthTools buffer kernels against plain scalar loops. The
+// results must match bit for bit for every length and alignment.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "SynthMark.h"
+#include "SynthRandom.h"
+#include "SynthTools.h"
+
+namespace {
+
+constexpr int32_t kMaxSamples = 67;
+// Leave room to offset the pointers from their natural alignment.
+constexpr int32_t kBufferSize = kMaxSamples + 8;
+
+int failures = 0;
+SynthRandom random;
+
+void FillRandom(synth_float_t* buffer, int32_t count) {
+  for (int32_t i = 0; i < count; i++)
+    buffer[i] = static_cast<synth_float_t>(random.nextDouble() * 4.0
+                                           - 2.0);
+}
+
+void Expect(const char* name, const synth_float_t* expected,
+            const synth_float_t* actual, int32_t count, int32_t offset) {
+  if (memcmp(expected, actual, count * sizeof(synth_float_t)) != 0) {
+    printf("FAIL %s: count = %d, offset = %d\n", name, count, offset);
+    failures++;
+  }
+}
+
+void TestKernels(int32_t count, int32_t offset) {
+  synth_float_t input1_storage[kBufferSize];
+  synth_float_t input2_storage[kBufferSize];
+  synth_float_t expected_storage[kBufferSize] = {};
+  synth_float_t actual_storage[kBufferSize] = {};
+  FillRandom(input1_storage, kBufferSize);
+  FillRandom(input2_storage, kBufferSize);
+  const synth_float_t* input1 = input1_storage + offset;
+  const synth_float_t* input2 = input2_storage + offset;
+  synth_float_t* expected = expected_storage + offset;
+  synth_float_t* actual = actual_storage + offset;
+  const synth_float_t gain1 = 0.3157f;
+  const synth_float_t gain2 = -1.0633f;
+
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = gain1;
+  SynthTools::fillBuffer(actual, count, gain1);
+  Expect("fillBuffer", expected, actual, count, offset);
+
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = input1[i] * gain1;
+  SynthTools::scaleBuffer(input1, actual, count, gain1);
+  Expect("scaleBuffer", expected, actual, count, offset);
+
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = (input1[i] * gain1) + gain2;
+  SynthTools::scaleOffsetBuffer(input1, actual, count, gain1, gain2);
+  Expect("scaleOffsetBuffer", expected, actual, count, offset);
+
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = (input1[i] * gain1) + (input2[i] * gain2);
+  SynthTools::mixBuffers(input1, gain1, input2, gain2, actual, count);
+  Expect("mixBuffers", expected, actual, count, offset);
+
+  // Both inputs advance: this is an element-wise product.
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = input1[i] * input2[i];
+  SynthTools::multiplyBuffers(input1, input2, actual, count);
+  Expect("multiplyBuffers", expected, actual, count, offset);
+
+  for (int32_t i = 0; i < count; i++) {
+    expected[i] = input2[i];
+    actual[i] = input2[i];
+  }
+  for (int32_t i = 0; i < count; i++)
+    expected[i] += input1[i] * gain1;
+  SynthTools::addBuffers(input1, gain1, actual, count);
+  Expect("addBuffers", expected, actual, count, offset);
+
+  for (int32_t i = 0; i < count; i++)
+    expected[i] = gain1 + (static_cast<synth_float_t>(i) * gain2);
+  SynthTools::fillRamp(actual, count, gain1, gain2);
+  Expect("fillRamp", expected, actual, count, offset);
+
+  // The geometric series is stepped per vector, so only compare closely.
+  const synth_float_t ratio = 0.9871f;
+  synth_float_t next = SynthTools::fillGeometric(actual, count, gain1, ratio);
+  for (int32_t i = 0; i <= count; i++) {
+    double exact = gain1 * pow(static_cast<double>(ratio), i);
+    synth_float_t value = (i < count) ? actual[i] : next;
+    if (fabs(value - exact) > 1.0e-6 * fabs(exact)) {
+      printf("FAIL fillGeometric: count = %d, offset = %d, i = %d\n", count,
+             offset, i);
+      failures++;
+      break;
+    }
+  }
+
+  // Kernels must not write past the end of the output.
+  actual[count] = 12345.0f;
+  SynthTools::fillBuffer(actual, count, gain1);
+  if (actual[count] != 12345.0f) {
+    printf("FAIL fillBuffer overrun: count = %d, offset = %d\n", count,
+           offset);
+    failures++;
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (int32_t offset = 0; offset < 4; offset++) {
+    for (int32_t count = 0; count <= kMaxSamples; count++)
+      TestKernels(count, offset);
+  }
+  printf("synth_tools_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
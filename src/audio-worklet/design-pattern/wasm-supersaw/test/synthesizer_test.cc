@@ -0,0 +1,336 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that Synthesizer::render fills every requested frame for any call
+// size and internal block size, that instances do not share state, and
+// that a random seed reproduces the output.
+//
+// Run with `make test` in the parent directory.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Synthesizer.h"
+
+namespace {
+
+constexpr int32_t kTestSampleRate = 48000;
+constexpr int32_t kMaxCallFrames = 300;
+
+int TestRenderFillsOutput(int32_t frames_per_block) {
+  Synthesizer synth(kTestSampleRate);
+  if (!synth.setFramesPerBlock(frames_per_block)) {
+    printf("FAIL setFramesPerBlock(%d) rejected\n", frames_per_block);
+    return 1;
+  }
+  synth.noteOn(60);
+  synth.noteOn(67);
+
+  float output[kMaxCallFrames + 1];
+  // Call sizes that do not line up with any block size.
+  const int32_t call_frames[] = {1, 7, 128, 3, 300, 33, 0, 129, 64};
+  for (int32_t repeat = 0; repeat < 20; repeat++) {
+    for (int32_t num_frames : call_frames) {
+      for (int32_t i = 0; i <= kMaxCallFrames; i++)
+        output[i] = NAN;
+      synth.render(output, num_frames);
+      for (int32_t i = 0; i < num_frames; i++) {
+        if (!std::isfinite(output[i])) {
+          printf("FAIL block = %d, call = %d: frame %d not written\n",
+                 frames_per_block, num_frames, i);
+          return 1;
+        }
+      }
+      if (!std::isnan(output[num_frames])) {
+        printf("FAIL block = %d, call = %d: wrote past the end\n",
+               frames_per_block, num_frames);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// The output must not depend on how the host slices the render calls.
+int TestCallSizeDoesNotChangeOutput() {
+  constexpr int32_t kTotalFrames = 4096;
+  Synthesizer whole(kTestSampleRate);
+  Synthesizer sliced(kTestSampleRate);
+  whole.setFramesPerBlock(32);
+  sliced.setFramesPerBlock(32);
+  whole.noteOn(60);
+  sliced.noteOn(60);
+
+  static float expected[kTotalFrames];
+  static float actual[kTotalFrames];
+  whole.render(expected, kTotalFrames);
+  int32_t position = 0;
+  int32_t call = 1;
+  while (position < kTotalFrames) {
+    int32_t num_frames = std::min(call, kTotalFrames - position);
+    sliced.render(actual + position, num_frames);
+    position += num_frames;
+    call = (call * 7 + 3) % 200;
+  }
+  if (memcmp(expected, actual, sizeof(expected)) != 0) {
+    printf("FAIL output depends on render call size\n");
+    return 1;
+  }
+  return 0;
+}
+
+// Count the frames from note off until the voice is recycled.
+int32_t MeasureReleaseFrames(int32_t sample_rate) {
+  Synthesizer synth(sample_rate);
+  float output[SYNTHMARK_FRAMES_PER_RENDER];
+  synth.noteOn(60);
+  for (int32_t i = 0; i < sample_rate / 10; i += SYNTHMARK_FRAMES_PER_RENDER)
+    synth.render(output, SYNTHMARK_FRAMES_PER_RENDER);
+  synth.noteOff(60);
+  int32_t frames = 0;
+  while (synth.getActiveVoiceCount() > 0 && frames < sample_rate) {
+    synth.render(output, SYNTHMARK_FRAMES_PER_RENDER);
+    frames += SYNTHMARK_FRAMES_PER_RENDER;
+  }
+  return frames;
+}
+
+// Envelope times are in seconds, so they must scale with the sample rate of
+// each instance.
+int TestEnvelopeFollowsSampleRate() {
+  int32_t frames_48k = MeasureReleaseFrames(48000);
+  int32_t frames_44k = MeasureReleaseFrames(44100);
+  double ratio = static_cast<double>(frames_44k) / frames_48k;
+  if (fabs(ratio - 44100.0 / 48000.0) > 0.02) {
+    printf("FAIL release took %d frames at 48k and %d frames at 44.1k\n",
+           frames_48k, frames_44k);
+    return 1;
+  }
+  return 0;
+}
+
+// A scheduled note must start on its frame, not on a render call boundary.
+int TestScheduledNoteIsSampleAccurate(int32_t frames_per_block) {
+  constexpr int64_t kStartFrame = 1001;
+  constexpr int32_t kTotalFrames = 2048;
+  Synthesizer synth(kTestSampleRate);
+  synth.setFramesPerBlock(frames_per_block);
+  float output[kTotalFrames];
+  synth.render(output, 100);
+  if (synth.getFrameTime() != 100) {
+    printf("FAIL frame time is %lld after 100 frames\n",
+           static_cast<long long>(synth.getFrameTime()));
+    return 1;
+  }
+  synth.scheduleNoteOn(60, kStartFrame);
+  for (int32_t position = 100; position < kTotalFrames; position += 128)
+    synth.render(output + position, std::min(128, kTotalFrames - position));
+
+  for (int64_t i = 0; i < kStartFrame; i++) {
+    if (output[i] != 0.0f) {
+      printf("FAIL block = %d: frame %lld is not silent\n", frames_per_block,
+             static_cast<long long>(i));
+      return 1;
+    }
+  }
+  if (output[kStartFrame] == 0.0f && output[kStartFrame + 1] == 0.0f) {
+    printf("FAIL block = %d: note did not start on frame %lld\n",
+           frames_per_block, static_cast<long long>(kStartFrame));
+    return 1;
+  }
+  return 0;
+}
+
+// A note played now must not wait for a scheduled note that is far ahead.
+int TestImmediateNoteIsNotBlocked() {
+  constexpr int32_t kNumFrames = 128;
+  Synthesizer synth(kTestSampleRate);
+  synth.scheduleNoteOn(64, kTestSampleRate * 60);
+  synth.noteOn(60);
+  float output[kNumFrames];
+  synth.render(output, kNumFrames);
+  if (synth.getActiveVoiceCount() != 1 || output[1] == 0.0f) {
+    printf("FAIL immediate note waited behind a scheduled note\n");
+    return 1;
+  }
+  return 0;
+}
+
+// A new note glides from the pitch of the note before it, even on a voice
+// that was silent.
+int TestNoteGlidesFromLastPitch() {
+  constexpr int32_t kWindowFrames = kTestSampleRate / 20;
+  constexpr int32_t kNumWindows = 8;
+  Synthesizer synth(kTestSampleRate);
+  // One sawtooth, so the output crosses zero once per period.
+  synth.controlChange(53, 127);
+  synth.controlChange(1, 0);
+  // Glide with a time constant of about 0.2 seconds.
+  synth.controlChange(50, 127);
+  synth.controlChange(1, 10);
+  synth.noteOn(48);
+  std::vector<float> output(kWindowFrames * kNumWindows);
+  synth.render(output.data(), kWindowFrames);
+  synth.noteOff(48);
+  synth.noteOn(72);
+  synth.render(output.data(), kWindowFrames * kNumWindows);
+
+  // Pitch 48 crosses about 6.5 times per window and pitch 72 about 26.
+  int32_t crossings[kNumWindows] = {};
+  for (int32_t i = 1; i < kWindowFrames * kNumWindows; i++) {
+    if (output[i - 1] <= 0.0f && output[i] > 0.0f)
+      crossings[i / kWindowFrames]++;
+  }
+  for (int32_t window = 1; window < kNumWindows; window++) {
+    // Allow for a crossing that lands just either side of a window edge.
+    if (crossings[window] < crossings[window - 1] - 1) {
+      printf("FAIL pitch fell from %d to %d crossings in window %d\n",
+             crossings[window - 1], crossings[window], window);
+      return 1;
+    }
+  }
+  if (crossings[0] > 13 || crossings[kNumWindows - 1] < crossings[0] + 8) {
+    printf("FAIL pitch did not glide, %d crossings at first, %d at last\n",
+           crossings[0], crossings[kNumWindows - 1]);
+    return 1;
+  }
+  return 0;
+}
+
+// Rendering on a thread pool must give exactly the single threaded output,
+// including while voices are being started, stolen and released.
+int TestRenderThreadsDoNotChangeOutput(int32_t num_threads) {
+  constexpr int32_t kTotalFrames = 200 * 128;
+  constexpr int32_t kMaxVoices = 12;
+  Synthesizer serial(kTestSampleRate, kMaxVoices);
+  Synthesizer parallel(kTestSampleRate, kMaxVoices);
+  if (!parallel.setRenderThreads(num_threads)) {
+    printf("SKIP %d render threads are not supported\n", num_threads);
+    return 0;
+  }
+  // Hold each note for 14 starts so that more notes sound than there are
+  // voices.
+  for (int32_t i = 0; i < 40; i++) {
+    int64_t frame_time = i * 500;
+    uint8_t pitch = static_cast<uint8_t>(40 + (i * 7) % 40);
+    serial.scheduleNoteOn(pitch, frame_time);
+    parallel.scheduleNoteOn(pitch, frame_time);
+    if (i >= 14) {
+      uint8_t old_pitch = static_cast<uint8_t>(40 + ((i - 14) * 7) % 40);
+      serial.scheduleNoteOff(old_pitch, frame_time);
+      parallel.scheduleNoteOff(old_pitch, frame_time);
+    }
+  }
+
+  static float expected[kTotalFrames];
+  static float actual[kTotalFrames];
+  for (int32_t position = 0; position < kTotalFrames; position += 128) {
+    serial.render(expected + position, 128);
+    parallel.render(actual + position, 128);
+  }
+  if (memcmp(expected, actual, sizeof(expected)) != 0) {
+    printf("FAIL output changes with %d render threads\n", num_threads);
+    return 1;
+  }
+  return 0;
+}
+
+// A seed must give the same output every time, and a different seed must
+// give different oscillator phases.
+int TestRandomSeed() {
+  constexpr int32_t kTotalFrames = 1024;
+  Synthesizer first(kTestSampleRate);
+  Synthesizer second(kTestSampleRate);
+  Synthesizer other(kTestSampleRate);
+  first.setRandomSeed(1234);
+  second.setRandomSeed(1234);
+  other.setRandomSeed(5678);
+  static float expected[kTotalFrames];
+  static float actual[kTotalFrames];
+  static float different[kTotalFrames];
+  Synthesizer* synths[] = {&first, &second, &other};
+  float* outputs[] = {expected, actual, different};
+  for (int32_t i = 0; i < 3; i++) {
+    synths[i]->noteOn(60);
+    synths[i]->noteOn(64);
+    synths[i]->render(outputs[i], kTotalFrames);
+  }
+  if (memcmp(expected, actual, sizeof(expected)) != 0) {
+    printf("FAIL the same seed gave different output\n");
+    return 1;
+  }
+  if (memcmp(expected, different, sizeof(expected)) == 0) {
+    printf("FAIL different seeds gave the same output\n");
+    return 1;
+  }
+  return 0;
+}
+
+// The cutoff is rounded to a whole MIDI value and clamped to 0..127.
+int TestFilterCutoffIsRoundedAndClamped() {
+  constexpr int32_t kTotalFrames = 1024;
+  const float values[][2] = {
+      {63.6f, 64.0f}, {500.0f, 127.0f}, {-5.0f, 0.0f}, {NAN, 0.0f}};
+  for (const auto& pair : values) {
+    static float expected[kTotalFrames];
+    static float actual[kTotalFrames];
+    float* outputs[] = {actual, expected};
+    for (int32_t i = 0; i < 2; i++) {
+      Synthesizer synth(kTestSampleRate);
+      synth.setFilterCutoff(pair[i]);
+      synth.noteOn(60);
+      synth.render(outputs[i], kTotalFrames);
+    }
+    if (memcmp(expected, actual, sizeof(expected)) != 0) {
+      printf("FAIL cutoff %g did not act as %g\n", pair[0], pair[1]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+  const int32_t block_sizes[] = {8, 16, 32, 64, 128};
+  for (int32_t frames_per_block : block_sizes)
+    failures += TestRenderFillsOutput(frames_per_block);
+
+  failures += TestCallSizeDoesNotChangeOutput();
+  for (int32_t frames_per_block : block_sizes)
+    failures += TestScheduledNoteIsSampleAccurate(frames_per_block);
+  failures += TestImmediateNoteIsNotBlocked();
+  failures += TestNoteGlidesFromLastPitch();
+  failures += TestEnvelopeFollowsSampleRate();
+  failures += TestRenderThreadsDoNotChangeOutput(2);
+  failures += TestRenderThreadsDoNotChangeOutput(4);
+  failures += TestRandomSeed();
+  failures += TestFilterCutoffIsRoundedAndClamped();
+
+  Synthesizer synth(kTestSampleRate);
+  if (synth.setFramesPerBlock(48) || synth.getFramesPerBlock() != 8) {
+    printf("FAIL unsupported block size was accepted\n");
+    failures++;
+  }
+
+  printf("synthesizer_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
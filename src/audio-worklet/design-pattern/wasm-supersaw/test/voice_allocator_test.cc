@@ -0,0 +1,177 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that VoiceAllocator ignores pitches above 127, retriggers a held
+// pitch on its own voice, steals the right voice when the pool is full and
+// hands released voices out again.
+//
+// Run with `make test` in the parent directory.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "SynthMark.h"
+#include "SynthSimd.h"
+#include "VoiceAllocator.h"
+
+namespace {
+
+constexpr int32_t kNumVoices = 4;
+
+// Only what the allocator asks of a voice.
+struct TestVoice {
+  bool released = false;
+  synth_float_t amplitude = 1.0f;
+
+  bool isReleased() { return released; }
+  synth_float_t getAmplitude() { return amplitude; }
+};
+
+using Allocator = VoiceAllocator<TestVoice>;
+
+int TestRejectsPitchesAbove127() {
+  Allocator voices(kNumVoices);
+  bool stolen = true;
+  if (voices.noteOn(127, &stolen) == Allocator::kNoVoice || stolen) {
+    printf("FAIL pitch 127 did not get a voice\n");
+    return 1;
+  }
+  for (int pitch = 128; pitch <= 255; pitch++) {
+    stolen = true;
+    if (voices.noteOn(static_cast<uint8_t>(pitch), &stolen)
+            != Allocator::kNoVoice || stolen) {
+      printf("FAIL noteOn(%d) was not rejected\n", pitch);
+      return 1;
+    }
+    if (voices.noteOff(static_cast<uint8_t>(pitch)) != Allocator::kNoVoice) {
+      printf("FAIL noteOff(%d) was not rejected\n", pitch);
+      return 1;
+    }
+  }
+  if (voices.getActiveCount() != 1) {
+    printf("FAIL %d voices active after rejected notes, expected 1\n",
+           voices.getActiveCount());
+    return 1;
+  }
+  return 0;
+}
+
+int TestRetriggerReusesVoice() {
+  Allocator voices(kNumVoices);
+  bool stolen = false;
+  int32_t first = voices.noteOn(60, &stolen);
+  int32_t again = voices.noteOn(60, &stolen);
+  if (again != first || stolen || voices.getActiveCount() != 1) {
+    printf("FAIL retriggered pitch got voice %d (stolen %d), expected %d\n",
+           again, stolen, first);
+    return 1;
+  }
+  if (voices.noteOff(60) != first
+      || voices.noteOff(60) != Allocator::kNoVoice) {
+    printf("FAIL noteOff did not unmap the retriggered voice\n");
+    return 1;
+  }
+  return 0;
+}
+
+int TestStealsWhenFull() {
+  Allocator voices(kNumVoices);
+  bool stolen = false;
+  int32_t voiceOf[kNumVoices];
+  for (int32_t n = 0; n < kNumVoices; n++) {
+    voiceOf[n] = voices.noteOn(static_cast<uint8_t>(60 + n), &stolen);
+    if (stolen) {
+      printf("FAIL note %d stole with free voices left\n", n);
+      return 1;
+    }
+  }
+
+  // Every voice is held, so the oldest note is taken.
+  int32_t index = voices.noteOn(70, &stolen);
+  if (index != voiceOf[0] || !stolen) {
+    printf("FAIL stole voice %d (stolen %d), expected the oldest %d\n",
+           index, stolen, voiceOf[0]);
+    return 1;
+  }
+  if (voices.noteOff(60) != Allocator::kNoVoice) {
+    printf("FAIL the stolen pitch still maps to a voice\n");
+    return 1;
+  }
+
+  // A released voice is taken before a held one, the quietest first.
+  voices.getVoice(voiceOf[2]).released = true;
+  voices.getVoice(voiceOf[2]).amplitude = 0.5f;
+  voices.getVoice(voiceOf[3]).released = true;
+  voices.getVoice(voiceOf[3]).amplitude = 0.25f;
+  index = voices.noteOn(71, &stolen);
+  if (index != voiceOf[3] || !stolen) {
+    printf("FAIL stole voice %d, expected the quietest released %d\n",
+           index, voiceOf[3]);
+    return 1;
+  }
+  if (voices.getActiveCount() != kNumVoices) {
+    printf("FAIL stealing changed the active count to %d\n",
+           voices.getActiveCount());
+    return 1;
+  }
+  return 0;
+}
+
+int TestReleaseFreesVoice() {
+  Allocator voices(kNumVoices);
+  bool stolen = false;
+  int32_t voiceOf[kNumVoices];
+  for (int32_t n = 0; n < kNumVoices; n++)
+    voiceOf[n] = voices.noteOn(static_cast<uint8_t>(60 + n), &stolen);
+
+  // Releasing a voice that still holds a pitch unmaps the pitch.
+  voices.release(voiceOf[1]);
+  voices.release(voiceOf[1]);
+  if (voices.getActiveCount() != kNumVoices - 1
+      || voices.noteOff(61) != Allocator::kNoVoice) {
+    printf("FAIL release left %d voices active or the pitch mapped\n",
+           voices.getActiveCount());
+    return 1;
+  }
+  for (int32_t n = 0; n < voices.getActiveCount(); n++) {
+    if (voices.getActiveVoice(n) == voiceOf[1]) {
+      printf("FAIL released voice is still in the active list\n");
+      return 1;
+    }
+  }
+
+  // The next note takes the freed voice instead of stealing.
+  int32_t index = voices.noteOn(72, &stolen);
+  if (index != voiceOf[1] || stolen
+      || voices.getActiveCount() != kNumVoices) {
+    printf("FAIL new note got voice %d (stolen %d), expected freed %d\n",
+           index, stolen, voiceOf[1]);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  int failures = TestRejectsPitchesAbove127();
+  failures += TestRetriggerReusesVoice();
+  failures += TestStealsWhenFull();
+  failures += TestReleaseFreesVoice();
+  printf("voice_allocator_test (%s): %s\n", SYNTHMARK_SIMD_NAME,
+         failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
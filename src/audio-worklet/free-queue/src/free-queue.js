@@ -2,7 +2,8 @@
  * A shared storage for FreeQueue operation backed by SharedArrayBuffer.
  *
  * @typedef SharedRingBuffer
- * @property {Uint32Array} states Backed by SharedArrayBuffer.
+ * @property {Int32Array} states Backed by SharedArrayBuffer. Int32Array so
+ * that Atomics.wait() and Atomics.notify() work on it.
  * @property {number} bufferLength The frame buffer length. Should be identical
  * throughout channels.
  * @property {Array<Float32Array>} channelData The length must be > 0.
@@ -18,15 +19,33 @@
 class FreeQueue {
 
   /**
-   * An index set for shared state fields. Requires atomic access.
+   * An index set for shared state fields. Requires atomic access. READ and
+   * WRITE are a cache line apart, matching FreeQueueState in free_queue.h.
    * @enum {number}
    */
   States = {
     /** @type {number} A shared index for reading from the queue. (consumer) */
     READ: 0,
+    /** @type {number} Space the blocked producer waits for, or 0. */
+    PRODUCER_WAIT: 2,
     /** @type {number} A shared index for writing into the queue. (producer) */
-    WRITE: 1,  
+    WRITE: 16,
+    /** @type {number} Frames the blocked consumer waits for, or 0. */
+    CONSUMER_WAIT: 18,
   }
+
+  /**
+   * Length of the state array, two 64 byte cache lines.
+   * @type {number}
+   */
+  static STATE_LENGTH = 32;
+
+  /**
+   * Header values that identify a region made by free_queue.h.
+   * @type {number}
+   */
+  static REGION_MAGIC = 0x46515545;
+  static REGION_VERSION = 1;
   
   /**
    * FreeQueue constructor. A shared buffer created by this constructor
@@ -36,9 +55,9 @@ class FreeQueue {
    * @param {number} channelCount Total channel count.
    */
   constructor(size, channelCount = 1) {
-    this.states = new Uint32Array(
+    this.states = new Int32Array(
       new SharedArrayBuffer(
-        Object.keys(this.States).length * Uint32Array.BYTES_PER_ELEMENT
+        FreeQueue.STATE_LENGTH * Int32Array.BYTES_PER_ELEMENT
       )
     );
     /**
@@ -80,9 +99,10 @@ class FreeQueue {
     const HEAPF32 = new Float32Array(queuePointers.memory.buffer);
     const bufferLength = HEAPU32[queuePointers.bufferLengthPointer / 4];
     const channelCount = HEAPU32[queuePointers.channelCountPointer / 4];
-    const states = HEAPU32.subarray(
-        HEAPU32[queuePointers.statePointer / 4] / 4,
-        HEAPU32[queuePointers.statePointer / 4] / 4 + 2
+    const states = new Int32Array(
+        queuePointers.memory.buffer,
+        HEAPU32[queuePointers.statePointer / 4],
+        FreeQueue.STATE_LENGTH
     );
     const channelData = [];
     for (let i = 0; i < channelCount; i++) {
@@ -101,6 +121,40 @@ class FreeQueue {
     return queue;
   }
 
+  /**
+   * Helper function for creating FreeQueue from a region laid out by
+   * CreateFreeQueueInRegion() in free_queue.h. The region holds offsets
+   * rather than pointers, so no pointers need to be chased.
+   * @param {ArrayBuffer|SharedArrayBuffer} buffer Memory holding the region,
+   *   eg. a SharedArrayBuffer or WebAssembly.Memory.buffer.
+   * @param {number} byteOffset Start of the region in the buffer.
+   * @returns FreeQueue
+   */
+  static fromRegion(buffer, byteOffset = 0) {
+    // struct FreeQueueRegionHeader
+    const header = new Uint32Array(buffer, byteOffset, 7);
+    if (header[0] !== FreeQueue.REGION_MAGIC ||
+        header[1] !== FreeQueue.REGION_VERSION) {
+      throw new Error(`No FreeQueue region at offset ${byteOffset}.`);
+    }
+    const queue = new FreeQueue(0, 0);
+    queue.bufferLength = header[2];
+    queue.channelCount = header[3];
+    queue.states = new Int32Array(
+        buffer, byteOffset + header[4], FreeQueue.STATE_LENGTH);
+    queue.channelData = [];
+    for (let i = 0; i < queue.channelCount; i++) {
+      queue.channelData.push(
+          new Float32Array(
+              buffer,
+              byteOffset + header[5] + i * header[6],
+              queue.bufferLength
+          )
+      );
+    }
+    return queue;
+  }
+
   /**
    * Pushes the data into queue. Used by producer.
    *
@@ -150,6 +204,7 @@ class FreeQueue {
       if (nextWrite === this.bufferLength) nextWrite = 0;
     }
     Atomics.store(this.states, this.States.WRITE, nextWrite);
+    this._notifyWaiter(this.States.WRITE);
     return true;
   }
 
@@ -204,6 +259,7 @@ class FreeQueue {
       }
     }
     Atomics.store(this.states, this.States.READ, nextRead);
+    this._notifyWaiter(this.States.READ);
     return true;
   }
   /**
@@ -236,6 +292,34 @@ class FreeQueue {
     return this.getAvailableSamples() >= size;
   }
 
+  /**
+   * Blocks until blockLength frames can be pulled. Used by consumer, only in
+   * a worker, as the main thread and the audio thread cannot block. The
+   * producer wakes it only once blockLength frames are there.
+   *
+   * @param {number} blockLength Frames to wait for.
+   * @param {number} timeout Milliseconds to wait at most.
+   * @return {boolean} False on timeout, or at once if blockLength is more
+   *   than getBufferLength().
+   */
+  waitForRead(blockLength, timeout = Infinity) {
+    return this._waitForIndex(this.States.WRITE, blockLength, timeout);
+  }
+
+  /**
+   * Blocks until there is space to push blockLength frames. Used by
+   * producer, only in a worker. The consumer wakes it only once the space
+   * is there, so a large blockLength means fewer wakeups.
+   *
+   * @param {number} blockLength Frames of space to wait for.
+   * @param {number} timeout Milliseconds to wait at most.
+   * @return {boolean} False on timeout, or at once if blockLength is more
+   *   than getBufferLength().
+   */
+  waitForWrite(blockLength, timeout = Infinity) {
+    return this._waitForIndex(this.States.READ, blockLength, timeout);
+  }
+
   /**
    * @return {number}
    */
@@ -254,6 +338,49 @@ class FreeQueue {
     return writeIndex + this.bufferLength - readIndex;
   }
 
+  _getAvailable(index) {
+    const currentRead = Atomics.load(this.states, this.States.READ);
+    const currentWrite = Atomics.load(this.states, this.States.WRITE);
+    return index === this.States.WRITE
+        ? this._getAvailableRead(currentRead, currentWrite)
+        : this._getAvailableWrite(currentRead, currentWrite);
+  }
+
+  /**
+   * Called after index, READ or WRITE, moves. Wakes the other side if it
+   * waits for no more than is now there. Matches _notifyWaiter() in
+   * free_queue.h, so either side may be JS or C.
+   */
+  _notifyWaiter(index) {
+    const wait = index === this.States.WRITE
+        ? this.States.CONSUMER_WAIT : this.States.PRODUCER_WAIT;
+    const waiting = Atomics.load(this.states, wait);
+    if (waiting === 0 || this._getAvailable(index) < waiting) return;
+    if (Atomics.compareExchange(this.states, wait, waiting, 0) === waiting) {
+      Atomics.notify(this.states, index, 1);
+    }
+  }
+
+  _waitForIndex(index, blockLength, timeout) {
+    const wait = index === this.States.WRITE
+        ? this.States.CONSUMER_WAIT : this.States.PRODUCER_WAIT;
+    if (blockLength > this.bufferLength - 1) return false;
+    const deadline = performance.now() + timeout;
+    while (this._getAvailable(index) < blockLength) {
+      const otherIndex = Atomics.load(this.states, index);
+      Atomics.store(this.states, wait, blockLength);
+      if (this._getAvailable(index) >= blockLength) break;
+      const remaining = deadline - performance.now();
+      if (remaining <= 0) {
+        Atomics.store(this.states, wait, 0);
+        return false;
+      }
+      Atomics.wait(this.states, index, otherIndex, remaining);
+    }
+    Atomics.store(this.states, wait, 0);
+    return true;
+  }
+
   _reset() {
     for (let channel = 0; channel < this.channelCount; channel++) {
       this.channelData[channel].fill(0);
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput of FreeQueuePush and FreeQueuePull, which copy each channel in
+// at most two runs, against the per-sample loops they replaced.
+//
+// One thread pushes and pulls in turn, so this measures the copies and the
+// index updates, not the handoff between threads. The queue holds 3.3
+// blocks, so most calls wrap around the end of the buffer. Each size is run
+// several times and the best run is reported.
+//
+// Build and run with `make bench` in the parent directory.
+
+#define EMSCRIPTEN_KEEPALIVE
+#define FREE_QUEUE_IMPL
+#include "free_queue.h"
+
+#define NUM_RUNS 5
+// Samples copied per run, over all channels.
+#define SAMPLES_PER_RUN (1 << 24)
+
+// The push and pull from before the two-run copy, for comparison. They use
+// the same indices, but copy one sample at a time with a modulo each.
+static bool PushPerSample(
+  struct FreeQueue *queue, float **input, size_t block_length
+) {
+  uint32_t current_read = atomic_load(queue->state + READ);
+  uint32_t current_write = atomic_load(queue->state + WRITE);
+  if (_getAvailableWrite(queue, current_read, current_write) < block_length) {
+    return false;
+  }
+  for (uint32_t i = 0; i < block_length; i++) {
+    for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+      queue->channel_data[channel][(current_write + i) % queue->buffer_length] =
+          input[channel][i];
+    }
+  }
+  uint32_t next_write = (current_write + block_length) % queue->buffer_length;
+  atomic_store(queue->state + WRITE, next_write);
+  return true;
+}
+
+static bool PullPerSample(
+  struct FreeQueue *queue, float **output, size_t block_length
+) {
+  uint32_t current_read = atomic_load(queue->state + READ);
+  uint32_t current_write = atomic_load(queue->state + WRITE);
+  if (_getAvailableRead(queue, current_read, current_write) < block_length) {
+    return false;
+  }
+  for (uint32_t i = 0; i < block_length; i++) {
+    for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+      output[channel][i] =
+          queue->channel_data[channel][(current_read + i) % queue->buffer_length];
+    }
+  }
+  uint32_t next_read = (current_read + block_length) % queue->buffer_length;
+  atomic_store(queue->state + READ, next_read);
+  return true;
+}
+
+typedef bool (*CopyFunction)(struct FreeQueue *, float **, size_t);
+
+// Returns the best throughput in millions of samples per second, or 0 if
+// the output did not match the input.
+static double MeasureThroughput(
+  CopyFunction push, CopyFunction pull, size_t block_length,
+  size_t channel_count
+) {
+  struct FreeQueue *queue =
+      CreateFreeQueue(block_length * 3 + block_length / 3, channel_count);
+  float **input = (float **)malloc(channel_count * sizeof(float *));
+  float **output = (float **)malloc(channel_count * sizeof(float *));
+  for (size_t channel = 0; channel < channel_count; channel++) {
+    input[channel] = (float *)malloc(block_length * sizeof(float));
+    output[channel] = (float *)malloc(block_length * sizeof(float));
+    for (size_t i = 0; i < block_length; i++) {
+      input[channel][i] = (float)(channel * block_length + i);
+    }
+  }
+
+  size_t num_blocks = SAMPLES_PER_RUN / (block_length * channel_count);
+  double best_seconds = 0;
+  bool matched = true;
+  for (int run = 0; run < NUM_RUNS; run++) {
+    int64_t start = _getTimeNanos();
+    for (size_t block = 0; block < num_blocks; block++) {
+      push(queue, input, block_length);
+      pull(queue, output, block_length);
+    }
+    double seconds = (_getTimeNanos() - start) * 1e-9;
+    if (run == 0 || seconds < best_seconds) {
+      best_seconds = seconds;
+    }
+    for (size_t channel = 0; channel < channel_count; channel++) {
+      matched = matched && memcmp(input[channel], output[channel],
+          block_length * sizeof(float)) == 0;
+    }
+  }
+
+  for (size_t channel = 0; channel < channel_count; channel++) {
+    free(input[channel]);
+    free(output[channel]);
+  }
+  free(input);
+  free(output);
+  DestroyFreeQueue(queue);
+  if (!matched) {
+    return 0;
+  }
+  return num_blocks * block_length * channel_count / best_seconds * 1e-6;
+}
+
+int main(void) {
+  const size_t block_lengths[] = {128, 256, 512, 1024, 2048, 4096};
+  const size_t channel_counts[] = {1, 2, 4, 8, 16};
+  int failures = 0;
+  printf("Push + pull throughput, millions of samples per second\n");
+  printf("block  channels  per-sample  two-run  speedup\n");
+  for (size_t b = 0; b < sizeof(block_lengths) / sizeof(size_t); b++) {
+    for (size_t c = 0; c < sizeof(channel_counts) / sizeof(size_t); c++) {
+      size_t block_length = block_lengths[b];
+      size_t channel_count = channel_counts[c];
+      double per_sample = MeasureThroughput(
+          PushPerSample, PullPerSample, block_length, channel_count);
+      double two_run = MeasureThroughput(
+          FreeQueuePush, FreeQueuePull, block_length, channel_count);
+      if (per_sample == 0 || two_run == 0) {
+        printf("FAIL block %zu, %zu channels: output does not match input\n",
+            block_length, channel_count);
+        failures++;
+        continue;
+      }
+      printf("%5zu  %8zu  %10.0f  %7.0f  %6.1fx\n", block_length,
+          channel_count, per_sample, two_run, two_run / per_sample);
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
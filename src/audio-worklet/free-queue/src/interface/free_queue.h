@@ -7,13 +7,44 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#if defined(__EMSCRIPTEN__)
+// Waits use the memory.atomic.wait32 and memory.atomic.notify instructions.
+#elif defined(__linux__)
+// The implementation uses syscall() and clock_gettime(), which strict modes
+// such as -std=c11 hide. Compile the source file that defines
+// FREE_QUEUE_IMPL with -D_GNU_SOURCE, or in the default GNU C mode.
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * FreeQueue C Struct
+ * Size in bytes of a cache line. The producer and the consumer each own one
+ * line of the shared state, so that writing one index does not invalidate
+ * the other side's line.
+ */
+#define FREE_QUEUE_CACHE_LINE_SIZE 64
+
+/**
+ * Number of atomic_uint slots in the shared state, two cache lines.
+ */
+#define FREE_QUEUE_STATE_LENGTH (2 * FREE_QUEUE_CACHE_LINE_SIZE / 4)
+
+/**
+ * Identifies a memory region laid out by CreateFreeQueueInRegion ("FQUE").
+ */
+#define FREE_QUEUE_REGION_MAGIC 0x46515545
+#define FREE_QUEUE_REGION_VERSION 1
+
+/**
+ * FreeQueue C Struct. This is a handle local to one process. Its pointers
+ * point into the queue's region, which may be shared.
  */
 struct FreeQueue {
   size_t buffer_length;
@@ -23,14 +54,44 @@ struct FreeQueue {
 };
 
 /**
- * An index set for shared state fields.
+ * Start of a queue's memory region. The region holds no pointers, only
+ * offsets in bytes from its start, so it can be mapped at any address in
+ * each process, or read from JS. It is laid out as
+ *   - this header, padded to a cache line,
+ *   - the state, two cache lines, at state_offset,
+ *   - channel_count channels of buffer_length floats, at
+ *     channel_data_offset, each one channel_stride bytes after the last.
+ *     Every channel starts on a cache line.
+ */
+struct FreeQueueRegionHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t buffer_length;
+  uint32_t channel_count;
+  uint32_t state_offset;
+  uint32_t channel_data_offset;
+  uint32_t channel_stride;
+};
+
+/**
+ * An index set for shared state fields. The consumer's line holds READ, its
+ * cache and the producer's wait request, the producer's line the reverse.
+ * Each side checks the wait request on its own line after every update.
  * @enum {number}
  */
 enum FreeQueueState {
   /** @type {number} A shared index for reading from the queue. (consumer) */
   READ = 0,
+  /** @type {number} The last WRITE seen by the consumer. Only it uses this. */
+  CACHED_WRITE = 1,
+  /** @type {number} Space the blocked producer waits for, or 0. */
+  PRODUCER_WAIT = 2,
   /** @type {number} A shared index for writing into the queue. (producer) */
-  WRITE = 1
+  WRITE = FREE_QUEUE_CACHE_LINE_SIZE / 4,
+  /** @type {number} The last READ seen by the producer. Only it uses this. */
+  CACHED_READ = FREE_QUEUE_CACHE_LINE_SIZE / 4 + 1,
+  /** @type {number} Frames the blocked consumer waits for, or 0. */
+  CONSUMER_WAIT = FREE_QUEUE_CACHE_LINE_SIZE / 4 + 2
 };
 
 /**
@@ -39,11 +100,44 @@ enum FreeQueueState {
 /**
  * Create a FreeQueue and returns pointer.
  * Takes length of FreeQueue and channel Count as parameters.
- * Returns pointer to created FreeQueue.
+ * Returns pointer to created FreeQueue, or NULL if it is too large, see
+ * GetFreeQueueRegionSize(), or out of memory.
  */
 EMSCRIPTEN_KEEPALIVE 
 struct FreeQueue *CreateFreeQueue(size_t length, size_t channel_count);
 
+/**
+ * Returns the size in bytes of the region for a FreeQueue with the given
+ * length and channel count. It is a multiple of FREE_QUEUE_CACHE_LINE_SIZE.
+ * Returns 0 if the region would be 4 GiB or more, which does not fit the
+ * 32 bit sizes and offsets of its header.
+ */
+EMSCRIPTEN_KEEPALIVE
+size_t GetFreeQueueRegionSize(size_t length, size_t channel_count);
+
+/**
+ * Create a FreeQueue in memory owned by the caller, eg. a SharedArrayBuffer,
+ * part of the wasm heap, or a shared memory mapping.
+ * Takes pointer to a region of GetFreeQueueRegionSize() bytes aligned to
+ * FREE_QUEUE_CACHE_LINE_SIZE, length of FreeQueue and channel count.
+ * Returns a handle for this process, or NULL if the region is not aligned
+ * or the queue is too large.
+ * DestroyFreeQueue frees the handle but not the region.
+ */
+EMSCRIPTEN_KEEPALIVE
+struct FreeQueue *CreateFreeQueueInRegion(
+    void *region, size_t length, size_t channel_count);
+
+/**
+ * Open a FreeQueue that CreateFreeQueueInRegion made in a region, which may
+ * be mapped at another address, eg. in another process.
+ * Returns a handle for this process, or NULL if the region is not aligned or
+ * does not hold a FreeQueue.
+ * DestroyFreeQueue frees the handle but not the region.
+ */
+EMSCRIPTEN_KEEPALIVE
+struct FreeQueue *AttachFreeQueue(void *region);
+
 /**
  * Push new data to FreeQueue.
  * Takes pointer to FreeQueue, pointer to input data,
@@ -62,9 +156,77 @@ bool FreeQueuePush(struct FreeQueue *queue, float **input, size_t block_length);
 EMSCRIPTEN_KEEPALIVE 
 bool FreeQueuePull(struct FreeQueue *queue, float **output, size_t block_length);
 
+/**
+ * Reserve space for block_length frames, to be rendered straight into the
+ * queue instead of pushed.
+ * Takes pointer to FreeQueue, block length, two arrays of channel_count
+ * pointers to fill in, and pointer to the first span length.
+ * The frames go to first[channel][0 .. first_length - 1], and then to
+ * second[channel][0 .. block_length - first_length - 1] if the space wraps
+ * around the end of the buffer.
+ * Returns false, and reserves nothing, if there is not enough space.
+ * Only the producer may call this.
+ */
+EMSCRIPTEN_KEEPALIVE
+bool FreeQueueBeginWrite(struct FreeQueue *queue, size_t block_length,
+    float **first, float **second, size_t *first_length);
+
+/**
+ * Publish block_length frames written to the space from FreeQueueBeginWrite.
+ * block_length must not be more than was reserved.
+ */
+EMSCRIPTEN_KEEPALIVE
+void FreeQueueCommitWrite(struct FreeQueue *queue, size_t block_length);
+
+/**
+ * Find block_length frames to be read straight from the queue instead of
+ * pulled. The spans are laid out as for FreeQueueBeginWrite.
+ * Returns false if fewer frames are available.
+ * Only the consumer may call this.
+ */
+EMSCRIPTEN_KEEPALIVE
+bool FreeQueueBeginRead(struct FreeQueue *queue, size_t block_length,
+    const float **first, const float **second, size_t *first_length);
+
+/**
+ * Release block_length frames from FreeQueueBeginRead back to the producer.
+ * block_length must not be more than was found.
+ */
+EMSCRIPTEN_KEEPALIVE
+void FreeQueueCommitRead(struct FreeQueue *queue, size_t block_length);
+
+/**
+ * Wait until block_length frames can be pulled.
+ * Takes pointer to FreeQueue, block length, and timeout in nanoseconds, or
+ * a negative timeout to wait forever.
+ * Returns true once the frames are there, or false on timeout. Also
+ * returns false at once, without waiting, if block_length is more than the
+ * length the queue was created with, as that can never be satisfied.
+ * The producer wakes the consumer only when block_length frames are there,
+ * so waiting for more frames at once means fewer wakeups.
+ * Only the consumer may call this, and never on the browser's main thread
+ * or audio thread, which cannot block.
+ */
+EMSCRIPTEN_KEEPALIVE
+bool FreeQueueWaitForRead(
+    struct FreeQueue *queue, size_t block_length, int64_t timeout_ns);
+
+/**
+ * Wait until there is space to push block_length frames.
+ * The counterpart of FreeQueueWaitForRead for the producer, and returns
+ * false in the same cases: on timeout, or at once if block_length is more
+ * than the length of the queue. A render thread
+ * can wait for space for a large block while the audio thread pulls small
+ * ones, and be woken once per block instead of once per pull.
+ */
+EMSCRIPTEN_KEEPALIVE
+bool FreeQueueWaitForWrite(
+    struct FreeQueue *queue, size_t block_length, int64_t timeout_ns);
+
 /**
  * Destroy FreeQueue.
  * Takes pointer to FreeQueue as parameter.
+ * Frees the region only if CreateFreeQueue allocated it.
  */
 EMSCRIPTEN_KEEPALIVE 
 void DestroyFreeQueue(struct FreeQueue *queue);
@@ -100,72 +262,427 @@ static uint32_t _getAvailableWrite(
   return read_index - write_index - 1;
 }
 
-struct FreeQueue *CreateFreeQueue(size_t length, size_t channel_count) {
-  struct FreeQueue *queue = (struct FreeQueue *)malloc(sizeof(struct FreeQueue));
-  queue->buffer_length = length + 1;
-  queue->channel_count = channel_count;
-  queue->state = (atomic_uint *)malloc(2 * sizeof(atomic_uint));
-  atomic_store(queue->state + READ, 0);
-  atomic_store(queue->state + WRITE, 0);
-
-  queue->channel_data = (float **)malloc(channel_count * sizeof(float *));
-  for (int i = 0; i < channel_count; i++) {
-    queue->channel_data[i] = (float *)malloc(queue->buffer_length * sizeof(float));
-    for (int j = 0; j < queue->buffer_length; j++) {
-      queue->channel_data[i][j] = 0;
-    }
+static size_t _roundUpToCacheLine(size_t size) {
+  return (size + FREE_QUEUE_CACHE_LINE_SIZE - 1) &
+      ~((size_t)FREE_QUEUE_CACHE_LINE_SIZE - 1);
+}
+
+static bool _isCacheLineAligned(void *region) {
+  return ((uintptr_t)region & (FREE_QUEUE_CACHE_LINE_SIZE - 1)) == 0;
+}
+
+/**
+ * Size of a handle and its table of channel_count channel pointers, rounded
+ * up so a region can follow it.
+ */
+static size_t _getHandleSize(size_t channel_count) {
+  return _roundUpToCacheLine(
+      sizeof(struct FreeQueue) + channel_count * sizeof(float *));
+}
+
+/**
+ * Points the handle and its channel table, which follows it, at the region.
+ */
+static struct FreeQueue *_bindFreeQueue(struct FreeQueue *queue, void *region) {
+  struct FreeQueueRegionHeader *header = (struct FreeQueueRegionHeader *)region;
+  char *base = (char *)region;
+  queue->buffer_length = header->buffer_length;
+  queue->channel_count = header->channel_count;
+  queue->state = (atomic_uint *)(base + header->state_offset);
+  queue->channel_data = (float **)(queue + 1);
+  for (uint32_t i = 0; i < header->channel_count; i++) {
+    queue->channel_data[i] = (float *)(base + header->channel_data_offset +
+        (size_t)i * header->channel_stride);
   }
   return queue;
 }
 
-void DestroyFreeQueue(struct FreeQueue *queue) {
-  for (int i = 0; i < queue->channel_count; i++) {
-    free(queue->channel_data[i]);
+/**
+ * Writes the header, clears the indices and zeroes the channel data.
+ * GetFreeQueueRegionSize() must have accepted the length and channel count,
+ * so every field fits its uint32_t.
+ */
+static void _formatRegion(void *region, size_t length, size_t channel_count) {
+  struct FreeQueueRegionHeader *header = (struct FreeQueueRegionHeader *)region;
+  // Use one extra bin to distinguish between the read and write indices
+  // when full.
+  size_t buffer_length = length + 1;
+  header->buffer_length = buffer_length;
+  header->channel_count = channel_count;
+  header->state_offset =
+      _roundUpToCacheLine(sizeof(struct FreeQueueRegionHeader));
+  header->channel_data_offset = header->state_offset +
+      FREE_QUEUE_STATE_LENGTH * sizeof(atomic_uint);
+  header->channel_stride = _roundUpToCacheLine(buffer_length * sizeof(float));
+
+  atomic_uint *state = (atomic_uint *)((char *)region + header->state_offset);
+  for (int i = 0; i < FREE_QUEUE_STATE_LENGTH; i++) {
+    atomic_init(state + i, 0);
   }
-  free(queue->channel_data);
+  memset((char *)region + header->channel_data_offset, 0,
+      channel_count * header->channel_stride);
+
+  header->version = FREE_QUEUE_REGION_VERSION;
+  header->magic = FREE_QUEUE_REGION_MAGIC;
+}
+
+size_t GetFreeQueueRegionSize(size_t length, size_t channel_count) {
+  // Every channel takes at least a cache line, and every field of the header
+  // is no larger than the region. Check the parts first and add up in 64
+  // bits, so nothing overflows a 32 bit size_t in wasm.
+  if (length >= UINT32_MAX / sizeof(float) ||
+      channel_count > UINT32_MAX / FREE_QUEUE_CACHE_LINE_SIZE) {
+    return 0;
+  }
+  uint64_t channel_stride =
+      ((uint64_t)(length + 1) * sizeof(float) + FREE_QUEUE_CACHE_LINE_SIZE - 1) &
+      ~(uint64_t)(FREE_QUEUE_CACHE_LINE_SIZE - 1);
+  uint64_t size = _roundUpToCacheLine(sizeof(struct FreeQueueRegionHeader)) +
+      FREE_QUEUE_STATE_LENGTH * sizeof(atomic_uint) +
+      channel_count * channel_stride;
+  return size <= UINT32_MAX ? (size_t)size : 0;
+}
+
+struct FreeQueue *CreateFreeQueue(size_t length, size_t channel_count) {
+  size_t region_size = GetFreeQueueRegionSize(length, channel_count);
+  if (region_size == 0) {
+    return NULL;
+  }
+  // The handle, its channel table and the region share one allocation.
+  size_t handle_size = _getHandleSize(channel_count);
+  char *block = (char *)aligned_alloc(FREE_QUEUE_CACHE_LINE_SIZE,
+      handle_size + region_size);
+  if (block == NULL) {
+    return NULL;
+  }
+  _formatRegion(block + handle_size, length, channel_count);
+  return _bindFreeQueue((struct FreeQueue *)block, block + handle_size);
+}
+
+struct FreeQueue *CreateFreeQueueInRegion(
+    void *region, size_t length, size_t channel_count) {
+  if (!_isCacheLineAligned(region) ||
+      GetFreeQueueRegionSize(length, channel_count) == 0) {
+    return NULL;
+  }
+  _formatRegion(region, length, channel_count);
+  return AttachFreeQueue(region);
+}
+
+struct FreeQueue *AttachFreeQueue(void *region) {
+  struct FreeQueueRegionHeader *header = (struct FreeQueueRegionHeader *)region;
+  if (!_isCacheLineAligned(region) ||
+      header->magic != FREE_QUEUE_REGION_MAGIC ||
+      header->version != FREE_QUEUE_REGION_VERSION) {
+    return NULL;
+  }
+  struct FreeQueue *queue =
+      (struct FreeQueue *)malloc(_getHandleSize(header->channel_count));
+  if (queue == NULL) {
+    return NULL;
+  }
+  return _bindFreeQueue(queue, region);
+}
+
+void DestroyFreeQueue(struct FreeQueue *queue) {
   free(queue);
 }
 
-bool FreeQueuePush(struct FreeQueue *queue, float **input, size_t block_length) {
-  uint32_t current_read = atomic_load(queue->state + READ);
-  uint32_t current_write = atomic_load(queue->state + WRITE);
+/**
+ * The producer reads its own WRITE index relaxed, and trusts its cached READ
+ * until that says the queue is too full. Only then does it load READ, with
+ * acquire ordering so the consumer is done with the frames it gave back.
+ * The cached READ can only lag behind, so it never overstates the space.
+ * Returns false if there is no room for block_length frames.
+ */
+static bool _reserveWrite(
+  struct FreeQueue *queue,
+  size_t block_length,
+  uint32_t *current_write
+) {
+  *current_write =
+      atomic_load_explicit(queue->state + WRITE, memory_order_relaxed);
+  uint32_t current_read =
+      atomic_load_explicit(queue->state + CACHED_READ, memory_order_relaxed);
 
-  if (_getAvailableWrite(queue, current_read, current_write) < block_length) {
-    return false;
+  if (_getAvailableWrite(queue, current_read, *current_write) < block_length) {
+    current_read =
+        atomic_load_explicit(queue->state + READ, memory_order_acquire);
+    atomic_store_explicit(queue->state + CACHED_READ, current_read,
+        memory_order_relaxed);
+    if (_getAvailableWrite(queue, current_read, *current_write) < block_length) {
+      return false;
+    }
   }
+  return true;
+}
 
-  for (uint32_t i = 0; i < block_length; i++) {
-    for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
-      queue->channel_data[channel][(current_write + i) % queue->buffer_length] = 
-          input[channel][i];
+/**
+ * The mirror image of _reserveWrite(). The consumer reloads WRITE, with
+ * acquire ordering so the frames are visible, only when its cached WRITE
+ * says there is too little to read.
+ */
+static bool _reserveRead(
+  struct FreeQueue *queue,
+  size_t block_length,
+  uint32_t *current_read
+) {
+  *current_read =
+      atomic_load_explicit(queue->state + READ, memory_order_relaxed);
+  uint32_t current_write =
+      atomic_load_explicit(queue->state + CACHED_WRITE, memory_order_relaxed);
+
+  if (_getAvailableRead(queue, *current_read, current_write) < block_length) {
+    current_write =
+        atomic_load_explicit(queue->state + WRITE, memory_order_acquire);
+    atomic_store_explicit(queue->state + CACHED_WRITE, current_write,
+        memory_order_relaxed);
+    if (_getAvailableRead(queue, *current_read, current_write) < block_length) {
+      return false;
     }
   }
+  return true;
+}
+
+/**
+ * Number of the block_length frames starting at index that fit before the
+ * end of the buffer. The rest wrap around to its start.
+ */
+static size_t _getFirstSpanLength(
+  struct FreeQueue *queue,
+  uint32_t index,
+  size_t block_length
+) {
+  size_t first_length = queue->buffer_length - index;
+  return first_length < block_length ? first_length : block_length;
+}
+
+static int64_t _getTimeNanos(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * Sleeps while *index is value, for up to timeout_ns, or forever if it is
+ * negative. May return early, so callers check again.
+ */
+static void _waitOnIndex(atomic_uint *index, uint32_t value, int64_t timeout_ns) {
+#if defined(__EMSCRIPTEN__)
+  __builtin_wasm_memory_atomic_wait32((int *)index, (int)value, timeout_ns);
+#elif defined(__linux__)
+  // Not FUTEX_PRIVATE_FLAG, as the queue may be shared between processes.
+  struct timespec timeout = {
+    (time_t)(timeout_ns / 1000000000), (long)(timeout_ns % 1000000000)
+  };
+  syscall(SYS_futex, index, FUTEX_WAIT, value,
+      timeout_ns < 0 ? NULL : &timeout, NULL, 0);
+#else
+  // No futex here, so the caller polls.
+  (void)index;
+  (void)value;
+  (void)timeout_ns;
+#endif
+}
+
+static void _wakeIndex(atomic_uint *index) {
+#if defined(__EMSCRIPTEN__)
+  __builtin_wasm_memory_atomic_notify((int *)index, 1);
+#elif defined(__linux__)
+  syscall(SYS_futex, index, FUTEX_WAKE, 1, NULL, NULL, 0);
+#else
+  (void)index;
+#endif
+}
+
+/**
+ * Called after state, READ or WRITE, moves. Wakes the other side if it is
+ * waiting and the frames or space it asked for are now there.
+ */
+static void _notifyWaiter(struct FreeQueue *queue, enum FreeQueueState state) {
+  enum FreeQueueState wait = state == WRITE ? CONSUMER_WAIT : PRODUCER_WAIT;
+  // Sequentially consistent, like the index update before it and the
+  // waiter's accesses in _waitForIndex, so either this sees the wait request
+  // or the waiter sees the new index.
+  uint32_t waiting = atomic_load(queue->state + wait);
+  if (waiting == 0) {
+    return;
+  }
+  uint32_t current_read =
+      atomic_load_explicit(queue->state + READ, memory_order_relaxed);
+  uint32_t current_write =
+      atomic_load_explicit(queue->state + WRITE, memory_order_relaxed);
+  uint32_t available = state == WRITE
+      ? _getAvailableRead(queue, current_read, current_write)
+      : _getAvailableWrite(queue, current_read, current_write);
+  // Clearing the request makes sure only one update wakes the waiter.
+  if (available >= waiting &&
+      atomic_compare_exchange_strong(queue->state + wait, &waiting, 0)) {
+    _wakeIndex(queue->state + state);
+  }
+}
 
-  uint32_t next_write = (current_write + block_length) % queue->buffer_length;
-  atomic_store(queue->state + WRITE, next_write);
+/**
+ * Moves index forward by block_length, which hands the frames to the other
+ * side. The exchange is sequentially consistent for _notifyWaiter(), and is
+ * cheaper than a release store and a full fence.
+ */
+static void _advanceIndex(
+  struct FreeQueue *queue,
+  enum FreeQueueState state,
+  uint32_t index,
+  size_t block_length
+) {
+  uint32_t next_index = index + block_length;
+  if (next_index >= queue->buffer_length) {
+    next_index -= queue->buffer_length;
+  }
+  atomic_exchange(queue->state + state, next_index);
+  _notifyWaiter(queue, state);
+}
+
+/**
+ * Blocks until block_length frames, or frames of space, are there. The
+ * waiter posts block_length in its wait slot and sleeps on the index the
+ * other side moves, state.
+ */
+static bool _waitForIndex(
+  struct FreeQueue *queue,
+  enum FreeQueueState state,
+  size_t block_length,
+  int64_t timeout_ns
+) {
+  enum FreeQueueState wait = state == WRITE ? CONSUMER_WAIT : PRODUCER_WAIT;
+  // More than the queue holds would never be ready, so fail rather than
+  // sleep until the timeout, or forever.
+  if (block_length > queue->buffer_length - 1) {
+    return false;
+  }
+  int64_t deadline = timeout_ns < 0 ? -1 : _getTimeNanos() + timeout_ns;
+  uint32_t own_index;
+  for (;;) {
+    bool ready = state == WRITE
+        ? _reserveRead(queue, block_length, &own_index)
+        : _reserveWrite(queue, block_length, &own_index);
+    if (ready) {
+      break;
+    }
+    atomic_store(queue->state + wait, block_length);
+    uint32_t other_index = atomic_load(queue->state + state);
+    if (other_index != atomic_load_explicit(
+            queue->state + (state == WRITE ? CACHED_WRITE : CACHED_READ),
+            memory_order_relaxed)) {
+      // It moved since _reserve*() looked, so look again before sleeping.
+      continue;
+    }
+    int64_t remaining = -1;
+    if (deadline >= 0) {
+      remaining = deadline - _getTimeNanos();
+      if (remaining <= 0) {
+        atomic_store_explicit(queue->state + wait, 0, memory_order_relaxed);
+        return false;
+      }
+    }
+    _waitOnIndex(queue->state + state, other_index, remaining);
+  }
+  atomic_store_explicit(queue->state + wait, 0, memory_order_relaxed);
+  return true;
+}
+
+bool FreeQueuePush(struct FreeQueue *queue, float **input, size_t block_length) {
+  uint32_t current_write;
+  if (!_reserveWrite(queue, block_length, &current_write)) {
+    return false;
+  }
+
+  // Copy each channel in at most two runs, up to the end of the buffer and
+  // then from its start.
+  size_t first_length = _getFirstSpanLength(queue, current_write, block_length);
+  size_t second_length = block_length - first_length;
+  for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+    float *channel_data = queue->channel_data[channel];
+    memcpy(channel_data + current_write, input[channel],
+        first_length * sizeof(float));
+    memcpy(channel_data, input[channel] + first_length,
+        second_length * sizeof(float));
+  }
+
+  _advanceIndex(queue, WRITE, current_write, block_length);
   return true;
 }
 
 bool FreeQueuePull(struct FreeQueue *queue, float **output, size_t block_length) {
-  uint32_t current_read = atomic_load(queue->state + READ);
-  uint32_t current_write = atomic_load(queue->state + WRITE);
+  uint32_t current_read;
+  if (!_reserveRead(queue, block_length, &current_read)) {
+    return false;
+  }
+
+  size_t first_length = _getFirstSpanLength(queue, current_read, block_length);
+  size_t second_length = block_length - first_length;
+  for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+    const float *channel_data = queue->channel_data[channel];
+    memcpy(output[channel], channel_data + current_read,
+        first_length * sizeof(float));
+    memcpy(output[channel] + first_length, channel_data,
+        second_length * sizeof(float));
+  }
 
-  if (_getAvailableRead(queue, current_read, current_write) < block_length) {
+  _advanceIndex(queue, READ, current_read, block_length);
+  return true;
+}
+
+bool FreeQueueBeginWrite(struct FreeQueue *queue, size_t block_length,
+    float **first, float **second, size_t *first_length) {
+  uint32_t current_write;
+  if (!_reserveWrite(queue, block_length, &current_write)) {
     return false;
   }
 
-  for (uint32_t i = 0; i < block_length; i++) {
-    for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
-      output[channel][i] = 
-          queue->channel_data[channel][(current_read + i) % queue->buffer_length];
-    }
+  *first_length = _getFirstSpanLength(queue, current_write, block_length);
+  for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+    first[channel] = queue->channel_data[channel] + current_write;
+    second[channel] = queue->channel_data[channel];
+  }
+  return true;
+}
+
+void FreeQueueCommitWrite(struct FreeQueue *queue, size_t block_length) {
+  uint32_t current_write =
+      atomic_load_explicit(queue->state + WRITE, memory_order_relaxed);
+  _advanceIndex(queue, WRITE, current_write, block_length);
+}
+
+bool FreeQueueBeginRead(struct FreeQueue *queue, size_t block_length,
+    const float **first, const float **second, size_t *first_length) {
+  uint32_t current_read;
+  if (!_reserveRead(queue, block_length, &current_read)) {
+    return false;
   }
 
-  uint32_t nextRead = (current_read + block_length) % queue->buffer_length;
-  atomic_store(queue->state + READ, nextRead);
+  *first_length = _getFirstSpanLength(queue, current_read, block_length);
+  for (uint32_t channel = 0; channel < queue->channel_count; channel++) {
+    first[channel] = queue->channel_data[channel] + current_read;
+    second[channel] = queue->channel_data[channel];
+  }
   return true;
 }
 
+void FreeQueueCommitRead(struct FreeQueue *queue, size_t block_length) {
+  uint32_t current_read =
+      atomic_load_explicit(queue->state + READ, memory_order_relaxed);
+  _advanceIndex(queue, READ, current_read, block_length);
+}
+
+bool FreeQueueWaitForRead(
+    struct FreeQueue *queue, size_t block_length, int64_t timeout_ns) {
+  return _waitForIndex(queue, WRITE, block_length, timeout_ns);
+}
+
+bool FreeQueueWaitForWrite(
+    struct FreeQueue *queue, size_t block_length, int64_t timeout_ns) {
+  return _waitForIndex(queue, READ, block_length, timeout_ns);
+}
+
 void *GetFreeQueuePointerByMember(struct FreeQueue *queue, char *data) {
   if (strcmp(data, "buffer_length") == 0) {
     return &queue->buffer_length;
@@ -220,10 +737,10 @@ EMSCRIPTEN_KEEPALIVE void PrintQueueAddresses(struct FreeQueue *queue) {
       &queue->state, (size_t)&queue->state);
   printf("channel_data    : %p   uint: %zu\n", 
       &queue->channel_data, (size_t)&queue->channel_data);
-  printf("state[0]    : %p   uint: %zu\n", 
-      &queue->state[0], (size_t)&queue->state[0]);
-  printf("state[1]    : %p   uint: %zu\n", 
-      &queue->state[1], (size_t)&queue->state[1]);
+  printf("state[READ] : %p   uint: %zu\n", 
+      &queue->state[READ], (size_t)&queue->state[READ]);
+  printf("state[WRITE]: %p   uint: %zu\n", 
+      &queue->state[WRITE], (size_t)&queue->state[WRITE]);
 }
 
 #endif
@@ -0,0 +1,268 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks FreeQueueBeginWrite/CommitWrite and FreeQueueBeginRead/CommitRead
+// on one thread: spans that wrap around the end of the buffer, committing
+// less than was reserved, reservations that do not fit, and mixing them
+// with FreeQueuePush and FreeQueuePull on the same queue. The frames carry
+// a running count, so any frame lost, repeated or reordered shows up.
+//
+// Run with `make test` in the parent directory.
+
+#define EMSCRIPTEN_KEEPALIVE
+#define FREE_QUEUE_IMPL
+#include "free_queue.h"
+
+// The buffer holds one more frame than this.
+#define QUEUE_LENGTH 10
+#define CHANNEL_COUNT 2
+
+static float ExpectedSample(uint32_t frame, uint32_t channel) {
+  return (float)(frame * 2 + channel * 1000);
+}
+
+// Frames written and read so far.
+static uint32_t frames_written = 0;
+static uint32_t frames_read = 0;
+
+static int Push(struct FreeQueue *queue, size_t block_length) {
+  float input[CHANNEL_COUNT][QUEUE_LENGTH];
+  float *channels[CHANNEL_COUNT];
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    channels[channel] = input[channel];
+    for (uint32_t i = 0; i < block_length; i++) {
+      input[channel][i] = ExpectedSample(frames_written + i, channel);
+    }
+  }
+  if (!FreeQueuePush(queue, channels, block_length)) {
+    printf("FAIL could not push %zu frames\n", block_length);
+    return 1;
+  }
+  frames_written += block_length;
+  return 0;
+}
+
+static int Pull(struct FreeQueue *queue, size_t block_length) {
+  float output[CHANNEL_COUNT][QUEUE_LENGTH];
+  float *channels[CHANNEL_COUNT];
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    channels[channel] = output[channel];
+  }
+  if (!FreeQueuePull(queue, channels, block_length)) {
+    printf("FAIL could not pull %zu frames\n", block_length);
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (uint32_t i = 0; i < block_length; i++) {
+      if (output[channel][i] != ExpectedSample(frames_read + i, channel)) {
+        printf("FAIL pulled frame %u channel %u is %g, expected %g\n",
+            frames_read + i, channel, output[channel][i],
+            ExpectedSample(frames_read + i, channel));
+        return 1;
+      }
+    }
+  }
+  frames_read += block_length;
+  return 0;
+}
+
+// Checks that the spans start at the read or write index and wrap to the
+// start of the buffer.
+static int CheckSpans(struct FreeQueue *queue, uint32_t index,
+    const float **first, const float **second, size_t first_length,
+    size_t expected_first_length) {
+  if (first_length != expected_first_length) {
+    printf("FAIL first span has %zu frames, expected %zu\n", first_length,
+        expected_first_length);
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    if (first[channel] != queue->channel_data[channel] + index ||
+        second[channel] != queue->channel_data[channel]) {
+      printf("FAIL spans of channel %u are not at index %u and 0\n", channel,
+          index);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int TestWrappingWriteWithShortCommit(struct FreeQueue *queue) {
+  // Move both indices to 7, so 8 frames wrap after the first 4.
+  if (Push(queue, 7) || Pull(queue, 7)) {
+    return 1;
+  }
+  float *first[CHANNEL_COUNT];
+  float *second[CHANNEL_COUNT];
+  size_t first_length = 0;
+  if (!FreeQueueBeginWrite(queue, 8, first, second, &first_length)) {
+    printf("FAIL could not begin a write of 8 frames\n");
+    return 1;
+  }
+  if (CheckSpans(queue, 7, (const float **)first, (const float **)second,
+          first_length, 4)) {
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (uint32_t i = 0; i < 8; i++) {
+      float sample = ExpectedSample(frames_written + i, channel);
+      if (i < first_length) {
+        first[channel][i] = sample;
+      } else {
+        second[channel][i - first_length] = sample;
+      }
+    }
+  }
+  // Only 6 of the 8 frames are published. The next write starts after them.
+  FreeQueueCommitWrite(queue, 6);
+  frames_written += 6;
+  if (atomic_load(queue->state + WRITE) != 2) {
+    printf("FAIL WRITE is %u after a short commit, expected 2\n",
+        atomic_load(queue->state + WRITE));
+    return 1;
+  }
+  return 0;
+}
+
+static int TestReservationsThatDoNotFit(struct FreeQueue *queue) {
+  // 6 frames are queued, so there is space for 4.
+  float *first[CHANNEL_COUNT];
+  float *second[CHANNEL_COUNT];
+  const float *read_first[CHANNEL_COUNT];
+  const float *read_second[CHANNEL_COUNT];
+  size_t first_length = 0;
+  uint32_t write_index = atomic_load(queue->state + WRITE);
+  uint32_t read_index = atomic_load(queue->state + READ);
+  if (FreeQueueBeginWrite(queue, 5, first, second, &first_length) ||
+      FreeQueueBeginWrite(queue, QUEUE_LENGTH + 1, first, second,
+          &first_length)) {
+    printf("FAIL reserved more space than the queue has\n");
+    return 1;
+  }
+  if (FreeQueueBeginRead(queue, 7, read_first, read_second, &first_length) ||
+      FreeQueueBeginRead(queue, QUEUE_LENGTH + 1, read_first, read_second,
+          &first_length)) {
+    printf("FAIL found more frames than the queue has\n");
+    return 1;
+  }
+  if (atomic_load(queue->state + WRITE) != write_index ||
+      atomic_load(queue->state + READ) != read_index) {
+    printf("FAIL a failed reservation moved an index\n");
+    return 1;
+  }
+  return 0;
+}
+
+static int TestMixedWithPushAndPull(struct FreeQueue *queue) {
+  // Fill the queue, then read all of it through two wrapping spans.
+  if (Push(queue, 4)) {
+    return 1;
+  }
+  const float *first[CHANNEL_COUNT];
+  const float *second[CHANNEL_COUNT];
+  size_t first_length = 0;
+  if (!FreeQueueBeginRead(queue, QUEUE_LENGTH, first, second,
+          &first_length)) {
+    printf("FAIL could not begin a read of a full queue\n");
+    return 1;
+  }
+  if (CheckSpans(queue, 7, first, second, first_length, 4)) {
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+      float sample = i < first_length
+          ? first[channel][i] : second[channel][i - first_length];
+      if (sample != ExpectedSample(frames_read + i, channel)) {
+        printf("FAIL read frame %u channel %u is %g, expected %g\n",
+            frames_read + i, channel, sample,
+            ExpectedSample(frames_read + i, channel));
+        return 1;
+      }
+    }
+  }
+  // Give back 3 frames, and pull the other 7 normally.
+  FreeQueueCommitRead(queue, 3);
+  frames_read += 3;
+  if (Pull(queue, 7)) {
+    return 1;
+  }
+
+  // A direct write followed by a pull, and a push followed by a direct
+  // read.
+  float *write_first[CHANNEL_COUNT];
+  float *write_second[CHANNEL_COUNT];
+  if (!FreeQueueBeginWrite(queue, 5, write_first, write_second,
+          &first_length)) {
+    printf("FAIL could not begin a write into an empty queue\n");
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (uint32_t i = 0; i < 5; i++) {
+      float sample = ExpectedSample(frames_written + i, channel);
+      if (i < first_length) {
+        write_first[channel][i] = sample;
+      } else {
+        write_second[channel][i - first_length] = sample;
+      }
+    }
+  }
+  FreeQueueCommitWrite(queue, 5);
+  frames_written += 5;
+  if (Pull(queue, 5) || Push(queue, 3)) {
+    return 1;
+  }
+  if (!FreeQueueBeginRead(queue, 3, first, second, &first_length)) {
+    printf("FAIL could not begin a read after a push\n");
+    return 1;
+  }
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (uint32_t i = 0; i < 3; i++) {
+      float sample = i < first_length
+          ? first[channel][i] : second[channel][i - first_length];
+      if (sample != ExpectedSample(frames_read + i, channel)) {
+        printf("FAIL read frame %u channel %u after a push is %g\n",
+            frames_read + i, channel, sample);
+        return 1;
+      }
+    }
+  }
+  FreeQueueCommitRead(queue, 3);
+  frames_read += 3;
+
+  if (atomic_load(queue->state + READ) != atomic_load(queue->state + WRITE)) {
+    printf("FAIL the queue is not empty after reading every frame\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  struct FreeQueue *queue = CreateFreeQueue(QUEUE_LENGTH, CHANNEL_COUNT);
+  if (queue == NULL) {
+    printf("FAIL could not create the queue\n");
+    return 1;
+  }
+  // The tests continue from each other's queue state.
+  int failures = TestWrappingWriteWithShortCommit(queue);
+  if (failures == 0) {
+    failures += TestReservationsThatDoNotFit(queue);
+    failures += TestMixedWithPushAndPull(queue);
+  }
+  DestroyFreeQueue(queue);
+  printf("begin_commit_test: %s\n", failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
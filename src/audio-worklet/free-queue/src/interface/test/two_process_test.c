@@ -0,0 +1,191 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that a FreeQueue region is relocatable and can be shared between
+// processes. The parent creates the queue in a memfd mapping and attaches
+// to it again through a second mapping. A forked child attaches through a
+// third mapping at yet another address, and streams a known sequence that
+// the parent pulls and verifies. Also checks that AttachFreeQueue and
+// CreateFreeQueueInRegion reject bad regions. Needs Linux.
+//
+// Run with `make test` in the parent directory.
+
+#define EMSCRIPTEN_KEEPALIVE
+#define FREE_QUEUE_IMPL
+#include "free_queue.h"
+
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define QUEUE_LENGTH 1000
+#define CHANNEL_COUNT 3
+#define BLOCK_LENGTH 128
+#define TOTAL_FRAMES (1 << 20)
+
+static float ExpectedSample(uint32_t frame, uint32_t channel) {
+  // Exact in a float, and different in every channel.
+  return (float)((frame * 7 + channel * 1000003) & 0xffffff);
+}
+
+static void *MapRegion(int fd, size_t size) {
+  void *region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return region == MAP_FAILED ? NULL : region;
+}
+
+// Runs in the child. Returns the exit status.
+static int Produce(int fd, size_t size, void *parent_region) {
+  void *region = MapRegion(fd, size);
+  if (region == NULL || region == parent_region) {
+    printf("FAIL child could not map the region at a new address\n");
+    return 1;
+  }
+  struct FreeQueue *queue = AttachFreeQueue(region);
+  if (queue == NULL) {
+    printf("FAIL child could not attach\n");
+    return 1;
+  }
+  float input[CHANNEL_COUNT][BLOCK_LENGTH];
+  float *channels[CHANNEL_COUNT];
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    channels[channel] = input[channel];
+  }
+  for (uint32_t frame = 0; frame < TOTAL_FRAMES; frame += BLOCK_LENGTH) {
+    for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+      for (uint32_t i = 0; i < BLOCK_LENGTH; i++) {
+        input[channel][i] = ExpectedSample(frame + i, channel);
+      }
+    }
+    while (!FreeQueuePush(queue, channels, BLOCK_LENGTH)) {
+      sched_yield();
+    }
+  }
+  DestroyFreeQueue(queue);
+  munmap(region, size);
+  return 0;
+}
+
+static int Consume(struct FreeQueue *queue) {
+  float output[CHANNEL_COUNT][BLOCK_LENGTH];
+  float *channels[CHANNEL_COUNT];
+  for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+    channels[channel] = output[channel];
+  }
+  for (uint32_t frame = 0; frame < TOTAL_FRAMES; frame += BLOCK_LENGTH) {
+    while (!FreeQueuePull(queue, channels, BLOCK_LENGTH)) {
+      sched_yield();
+    }
+    for (uint32_t channel = 0; channel < CHANNEL_COUNT; channel++) {
+      for (uint32_t i = 0; i < BLOCK_LENGTH; i++) {
+        if (output[channel][i] != ExpectedSample(frame + i, channel)) {
+          printf("FAIL frame %u channel %u is %g, expected %g\n", frame + i,
+              channel, output[channel][i], ExpectedSample(frame + i, channel));
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+static int TestRejectsBadRegions(void *region, size_t size) {
+  char *base = (char *)region;
+  if (AttachFreeQueue(base + 4) != NULL ||
+      CreateFreeQueueInRegion(base + 4, QUEUE_LENGTH, CHANNEL_COUNT) != NULL) {
+    printf("FAIL accepted a misaligned region\n");
+    return 1;
+  }
+  // A cache line into the region there is no header.
+  if (size > FREE_QUEUE_CACHE_LINE_SIZE &&
+      AttachFreeQueue(base + FREE_QUEUE_CACHE_LINE_SIZE) != NULL) {
+    printf("FAIL attached to a region without a header\n");
+    return 1;
+  }
+  if (GetFreeQueueRegionSize((size_t)1 << 30, 1) != 0 ||
+      GetFreeQueueRegionSize(QUEUE_LENGTH, (size_t)1 << 30) != 0 ||
+      CreateFreeQueueInRegion(region, (size_t)1 << 30, 1) != NULL) {
+    printf("FAIL accepted a region of 4 GiB or more\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  int failures = 0;
+  size_t size = GetFreeQueueRegionSize(QUEUE_LENGTH, CHANNEL_COUNT);
+  int fd = memfd_create("two_process_test", 0);
+  if (fd < 0 || ftruncate(fd, size) != 0) {
+    printf("FAIL could not make a memfd region\n");
+    return 1;
+  }
+  void *created_region = MapRegion(fd, size);
+  void *attached_region = MapRegion(fd, size);
+  if (created_region == NULL || attached_region == NULL ||
+      created_region == attached_region) {
+    printf("FAIL could not map the region twice\n");
+    return 1;
+  }
+
+  failures += TestRejectsBadRegions(created_region, size);
+  struct FreeQueue *created =
+      CreateFreeQueueInRegion(created_region, QUEUE_LENGTH, CHANNEL_COUNT);
+  struct FreeQueue *queue = AttachFreeQueue(attached_region);
+  if (created == NULL || queue == NULL ||
+      queue->buffer_length != QUEUE_LENGTH + 1 ||
+      queue->channel_count != CHANNEL_COUNT) {
+    printf("FAIL could not create and attach the queue\n");
+    return 1;
+  }
+
+  fflush(stdout);
+  pid_t child = fork();
+  if (child == 0) {
+    // The parent's mappings stay in place, so the child's mapping lands at
+    // another address.
+    alarm(60);
+    int status = Produce(fd, size, attached_region);
+    fflush(stdout);
+    _exit(status);
+  }
+  if (child < 0) {
+    printf("FAIL could not fork\n");
+    return 1;
+  }
+  // Stop if the child dies before it has sent everything.
+  alarm(60);
+  bool consumed = Consume(queue) == 0;
+  if (!consumed) {
+    // The child would block on a full queue.
+    kill(child, SIGKILL);
+    failures++;
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  if (consumed && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+    printf("FAIL child exited with status %d\n", status);
+    failures++;
+  }
+
+  DestroyFreeQueue(queue);
+  DestroyFreeQueue(created);
+  munmap(attached_region, size);
+  munmap(created_region, size);
+  close(fd);
+  printf("two_process_test: %s\n", failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
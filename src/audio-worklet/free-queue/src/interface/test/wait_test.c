@@ -0,0 +1,253 @@
+/**
+ * Copyright 2026 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks FreeQueueWaitForRead and FreeQueueWaitForWrite: that they time
+// out, that they fail at once for blocks larger than the queue, that a
+// push or pull on another thread wakes them only once the whole block is
+// there, and that they clear their wait request. Then streams frames
+// between two threads that only ever wait without a timeout, so a missed
+// wakeup hangs and is caught by the alarm. Needs Linux.
+//
+// Run with `make test` in the parent directory.
+
+#define EMSCRIPTEN_KEEPALIVE
+#define FREE_QUEUE_IMPL
+#include "free_queue.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define QUEUE_LENGTH 1024
+#define BLOCK_LENGTH 256
+#define TIMEOUT_NS 20000000
+#define STREAM_FRAMES (1 << 20)
+
+static struct FreeQueue *queue;
+
+static void SleepNanos(int64_t nanos) {
+  struct timespec duration = {
+    (time_t)(nanos / 1000000000), (long)(nanos % 1000000000)
+  };
+  nanosleep(&duration, NULL);
+}
+
+static bool Push(size_t block_length, uint32_t first_frame) {
+  float input[QUEUE_LENGTH];
+  float *channels[1] = {input};
+  for (uint32_t i = 0; i < block_length; i++) {
+    input[i] = (float)(first_frame + i);
+  }
+  return FreeQueuePush(queue, channels, block_length);
+}
+
+// Returns false if the frames are not first_frame onwards.
+static bool Pull(size_t block_length, uint32_t first_frame) {
+  float output[QUEUE_LENGTH];
+  float *channels[1] = {output};
+  if (!FreeQueuePull(queue, channels, block_length)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < block_length; i++) {
+    if (output[i] != (float)(first_frame + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool WaitSlotsAreClear(void) {
+  return atomic_load(queue->state + CONSUMER_WAIT) == 0 &&
+      atomic_load(queue->state + PRODUCER_WAIT) == 0;
+}
+
+static int TestTimeout(void) {
+  // The queue is empty, so a read times out.
+  int64_t start = _getTimeNanos();
+  if (FreeQueueWaitForRead(queue, 1, TIMEOUT_NS) ||
+      _getTimeNanos() - start < TIMEOUT_NS) {
+    printf("FAIL wait for read did not time out after the timeout\n");
+    return 1;
+  }
+  // Filled up, so a write times out.
+  if (!Push(QUEUE_LENGTH, 0)) {
+    printf("FAIL could not fill the queue\n");
+    return 1;
+  }
+  start = _getTimeNanos();
+  if (FreeQueueWaitForWrite(queue, 1, TIMEOUT_NS) ||
+      _getTimeNanos() - start < TIMEOUT_NS) {
+    printf("FAIL wait for write did not time out after the timeout\n");
+    return 1;
+  }
+  if (!WaitSlotsAreClear()) {
+    printf("FAIL a timed out wait left its request behind\n");
+    return 1;
+  }
+  if (!Pull(QUEUE_LENGTH, 0)) {
+    printf("FAIL could not empty the queue\n");
+    return 1;
+  }
+  return 0;
+}
+
+static int TestTooLargeFailsAtOnce(void) {
+  // Without a timeout these would hang if they waited.
+  if (FreeQueueWaitForRead(queue, QUEUE_LENGTH + 1, -1) ||
+      FreeQueueWaitForWrite(queue, QUEUE_LENGTH + 1, -1)) {
+    printf("FAIL waited for more frames than the queue holds\n");
+    return 1;
+  }
+  // The whole queue is fine.
+  if (!FreeQueueWaitForWrite(queue, QUEUE_LENGTH, 0)) {
+    printf("FAIL an empty queue has no space for its whole length\n");
+    return 1;
+  }
+  if (!WaitSlotsAreClear()) {
+    printf("FAIL a wait that did not block left a request behind\n");
+    return 1;
+  }
+  return 0;
+}
+
+// Set by the helper threads if the waiter had stopped waiting too early.
+static bool woke_early = false;
+
+// Pushes a block in two halves while the main thread waits for all of it.
+static void *PushInHalves(void *unused) {
+  (void)unused;
+  SleepNanos(TIMEOUT_NS);
+  Push(BLOCK_LENGTH / 2, 0);
+  SleepNanos(TIMEOUT_NS);
+  // Half a block must not have woken the waiter or cleared its request.
+  woke_early = atomic_load(queue->state + CONSUMER_WAIT) != BLOCK_LENGTH;
+  Push(BLOCK_LENGTH / 2, BLOCK_LENGTH / 2);
+  return NULL;
+}
+
+// Pulls a block in two halves while the main thread waits for the space.
+static void *PullInHalves(void *unused) {
+  (void)unused;
+  SleepNanos(TIMEOUT_NS);
+  Pull(BLOCK_LENGTH / 2, 0);
+  SleepNanos(TIMEOUT_NS);
+  woke_early = atomic_load(queue->state + PRODUCER_WAIT) != BLOCK_LENGTH;
+  Pull(BLOCK_LENGTH / 2, BLOCK_LENGTH / 2);
+  return NULL;
+}
+
+static int TestWokenByOtherThread(void) {
+  pthread_t thread;
+  pthread_create(&thread, NULL, PushInHalves, NULL);
+  int64_t start = _getTimeNanos();
+  bool ready = FreeQueueWaitForRead(queue, BLOCK_LENGTH, -1);
+  int64_t elapsed = _getTimeNanos() - start;
+  pthread_join(thread, NULL);
+  if (!ready || woke_early || elapsed < 2 * TIMEOUT_NS) {
+    printf("FAIL wait for read returned %d after %lld ns, woke early %d\n",
+        ready, (long long)elapsed, woke_early);
+    return 1;
+  }
+  if (!WaitSlotsAreClear()) {
+    printf("FAIL the consumer's request was not cleared after a wake\n");
+    return 1;
+  }
+  if (!Pull(BLOCK_LENGTH, 0)) {
+    printf("FAIL the frames the consumer waited for are wrong\n");
+    return 1;
+  }
+
+  // Fill the queue, so pulling half a block frees too little space.
+  if (!Push(QUEUE_LENGTH, 0)) {
+    printf("FAIL could not fill the queue\n");
+    return 1;
+  }
+  pthread_create(&thread, NULL, PullInHalves, NULL);
+  start = _getTimeNanos();
+  ready = FreeQueueWaitForWrite(queue, BLOCK_LENGTH, -1);
+  elapsed = _getTimeNanos() - start;
+  pthread_join(thread, NULL);
+  if (!ready || woke_early || elapsed < 2 * TIMEOUT_NS) {
+    printf("FAIL wait for write returned %d after %lld ns, woke early %d\n",
+        ready, (long long)elapsed, woke_early);
+    return 1;
+  }
+  if (!WaitSlotsAreClear()) {
+    printf("FAIL the producer's request was not cleared after a wake\n");
+    return 1;
+  }
+  // Empty the queue for the next test.
+  if (!Pull(QUEUE_LENGTH - BLOCK_LENGTH, BLOCK_LENGTH)) {
+    printf("FAIL could not empty the queue\n");
+    return 1;
+  }
+  return 0;
+}
+
+// Writes in blocks of the whole queue and reads in small blocks, so both
+// sides block often.
+static void *Produce(void *result) {
+  for (uint32_t frame = 0; frame < STREAM_FRAMES; frame += QUEUE_LENGTH) {
+    if (!FreeQueueWaitForWrite(queue, QUEUE_LENGTH, -1) ||
+        !Push(QUEUE_LENGTH, frame)) {
+      *(bool *)result = false;
+      return NULL;
+    }
+  }
+  *(bool *)result = true;
+  return NULL;
+}
+
+static int TestStreamWithoutTimeouts(void) {
+  bool produced = false;
+  pthread_t thread;
+  pthread_create(&thread, NULL, Produce, &produced);
+  for (uint32_t frame = 0; frame < STREAM_FRAMES; frame += BLOCK_LENGTH / 2) {
+    if (!FreeQueueWaitForRead(queue, BLOCK_LENGTH / 2, -1) ||
+        !Pull(BLOCK_LENGTH / 2, frame)) {
+      printf("FAIL stream went wrong at frame %u\n", frame);
+      // The producer may be blocked for good.
+      return 1;
+    }
+  }
+  pthread_join(thread, NULL);
+  if (!produced) {
+    printf("FAIL the producer could not wait or push\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  // A lost wakeup would hang the test instead of failing it.
+  alarm(60);
+  queue = CreateFreeQueue(QUEUE_LENGTH, 1);
+  if (queue == NULL) {
+    printf("FAIL could not create the queue\n");
+    return 1;
+  }
+  int failures = TestTimeout();
+  failures += TestTooLargeFailsAtOnce();
+  // The tests below expect an empty queue.
+  if (failures == 0) {
+    failures += TestWokenByOtherThread();
+  }
+  if (failures == 0) {
+    failures += TestStreamWithoutTimeouts();
+  }
+  DestroyFreeQueue(queue);
+  printf("wait_test: %s\n", failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}